@@ -0,0 +1,222 @@
+/**
+ * @file bench.cpp
+ * @brief Micro-benchmarks of the hot paths of functions.h over a synthetic log
+ * Usage: bench [nbCases] [nbEvents] [nbActivities] [repetitions]
+ * Each benchmark keeps its best repetition and reports ns/op, events/s and allocations/op
+ * (allocations counted by replacing the global operator new)
+ * @date 17/10/2026
+ */
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <functional>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <numeric>
+#include <string>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+#include "typeDef.h"
+#include "functions.h"
+
+static atomic<size_t> nbAllocations(0);
+
+void * operator new(size_t aSize)
+{
+    nbAllocations.fetch_add(1, memory_order_relaxed);
+    void * memory = malloc(aSize != 0 ? aSize : 1);
+    if (memory == nullptr)
+        throw bad_alloc();
+    return memory;
+}
+
+void operator delete(void * aMemory) noexcept
+{
+    free(aMemory);
+}
+
+void operator delete(void * aMemory, size_t) noexcept
+{
+    free(aMemory);
+}
+
+/*
+ * Parameters of a run
+ * nbCases / nbEvents / nbActivities: the size of the synthetic log
+ * repetitions: the number of runs of each benchmark, the best one is kept
+ */
+struct BenchParameters
+{
+    int nbCases = 20000;
+    int nbEvents = 200000;
+    int nbActivities = 16;
+    int repetitions = 3;
+};
+
+/**
+ * @brief Write a synthetic log "id activity timestamp": the events of the cases are interleaved,
+ * each case follows one of a few variants (deterministic, same log for the same parameters)
+ * @param: string, the file name
+ * @param: const BenchParameters *, the size of the log
+ */
+void writeSyntheticLog(string aFileName, const BenchParameters * aParameters)
+{
+    ofstream of(aFileName, ios::binary);
+    uint64_t state = 88172645463325252ULL;
+    vector<int> positions(aParameters->nbCases, 0);
+    for (int i = 0; i < aParameters->nbEvents; ++i)
+    {
+        state ^= state << 13;   //xorshift
+        state ^= state >> 7;
+        state ^= state << 17;
+        int caseId = state % aParameters->nbCases;
+        int variant = caseId % 7;
+        int activity = (positions[caseId]++ * (variant + 1) + variant) % aParameters->nbActivities;
+        of << 1000000 + caseId << " act" << activity << ' ' << 1675450000 + i << '\n';
+    }
+}
+
+/**
+ * @brief Run a function with the console muted (the extraction functions display their progress)
+ * @param: function<void()>, the function
+ */
+void quiet(function<void()> aFunction)
+{
+    streambuf * console = cout.rdbuf();
+    ostringstream muted;
+    cout.rdbuf(muted.rdbuf());
+    aFunction();
+    cout.rdbuf(console);
+}
+
+/**
+ * @brief Run a benchmark aParameters->repetitions times with the console muted and display the best run
+ * @param: string, the name of the benchmark
+ * @param: const BenchParameters *, the parameters (repetitions)
+ * @param: int64_t, the number of operations of one run
+ * @param: int64_t, the number of events processed by one run
+ * @param: function<void()>, prepares a run (not timed)
+ * @param: function<void()>, the timed run
+ * @param: function<void()>, cleans after a run (not timed)
+ */
+void runBench(string aName, const BenchParameters * aParameters, int64_t nbOperations, int64_t nbEvents,
+              function<void()> aSetup, function<void()> aRun, function<void()> aTeardown)
+{
+    double best = -1;
+    size_t allocations = 0;
+    for (int i = 0; i < aParameters->repetitions; ++i)
+    {
+        size_t runAllocations = 0;
+        chrono::time_point<std::chrono::high_resolution_clock> startTime, endTime;
+        quiet([&]() {
+            aSetup();
+            size_t allocationsBefore = nbAllocations.load();
+            startTime = getTime();
+            aRun();
+            endTime = getTime();
+            runAllocations = nbAllocations.load() - allocationsBefore;
+            aTeardown();
+        });
+        double duration = calculateDuration(startTime, endTime);
+        if (best < 0 || duration < best)
+        {
+            best = duration;
+            allocations = runAllocations;
+        }
+    }
+    cout<<left<<setw(28)<<aName<<right<<setw(14)<<fixed<<setprecision(1)<<best * 1e9 / nbOperations<<setw(16);
+    if (nbEvents != 0 && best > 0)      //les recherches ne lisent pas d'évènements
+        cout<<setprecision(0)<<nbEvents / best;
+    else
+        cout<<'-';
+    cout<<setw(14)<<setprecision(3)<<(double)allocations / nbOperations<<endl;
+}
+
+int main(int argc, char ** argv)
+{
+    BenchParameters parameters;
+    if (argc > 1)
+        parameters.nbCases = max(1, atoi(argv[1]));
+    if (argc > 2)
+        parameters.nbEvents = max(1, atoi(argv[2]));
+    if (argc > 3)
+        parameters.nbActivities = max(1, atoi(argv[3]));
+    if (argc > 4)
+        parameters.repetitions = max(1, atoi(argv[4]));
+    string fileName = "benchDataset.txt";
+    writeSyntheticLog(fileName, &parameters);
+    cout<<parameters.nbCases<<" cases, "<<parameters.nbEvents<<" events, "<<parameters.nbActivities<<" activities, best of "
+        <<parameters.repetitions<<" runs"<<endl;
+
+    ProcessList * aList = nullptr;
+    auto newList = [&]() { aList = new ProcessList; };
+    auto clearList = [&]() { clear(aList); };
+
+    cout<<left<<setw(28)<<"benchmark"<<right<<setw(14)<<"ns/op"<<setw(16)<<"events/s"<<setw(14)<<"allocs/op"<<endl;
+    int64_t nbEvents = parameters.nbEvents;
+    runBench("nbOfLines", &parameters, 1, nbEvents, []() {}, [&]() { nbOfLines(fileName); }, []() {});
+    runBench("extractProcesses (/event)", &parameters, nbEvents, nbEvents, newList, [&]() { extractProcesses(aList, fileName); }, clearList);
+    runBench("extractProcessesMapped", &parameters, nbEvents, nbEvents, newList, [&]() { extractProcessesMapped(aList, fileName); }, clearList);
+    runBench("extractProcessesPipeline", &parameters, nbEvents, nbEvents, newList, [&]() { extractProcessesPipeline(aList, fileName); }, clearList);
+
+    ProcessList * processList = new ProcessList;
+    quiet([&]() { extractProcessesMapped(processList, fileName); });
+    vector<int> ids;
+    for (Process * ptr = processList->firstProcess; ptr != nullptr; ptr = ptr->nextProcess)
+        ids.push_back(ptr->id);
+    int64_t nbCases = ids.size();
+    runBench("processExists", &parameters, nbCases, 0, []() {}, [&]() {
+        for (size_t i = 0; i < ids.size(); ++i)
+            processExists(processList, ids[i]);
+    }, []() {});
+    runBench("processSummaryExists", &parameters, nbCases, 0, []() {}, [&]() {
+        for (size_t i = 0; i < ids.size(); ++i)
+            processSummaryExists(processList, ids[i]);
+    }, []() {});
+
+    vector<Activity *> activities;
+    Process * sorted = nullptr;
+    int stride = 7;     //premier avec nbActivities : i * stride % nbActivities est une permutation, aucun doublon refusé (et perdu)
+    while (gcd(stride, parameters.nbActivities) != 1)
+        stride++;
+    runBench("insertActivity", &parameters, parameters.nbActivities, 0, [&]() {
+        sorted = new Process;
+        activities.clear();
+        for (int i = 0; i < parameters.nbActivities; ++i)
+        {
+            Activity * anActivity = new Activity;
+            anActivity->code = internActivity("act" + to_string((int64_t)i * stride % parameters.nbActivities));
+            activities.push_back(anActivity);
+        }
+    }, [&]() {
+        for (size_t i = 0; i < activities.size(); ++i)
+            insertActivity(sorted, activities[i]);
+    }, [&]() {
+        clear(sorted);
+        delete sorted;
+    });
+
+    Process * activityList = nullptr;
+    auto newActivityList = [&]() { activityList = new Process; };
+    auto clearActivityList = [&]() { clear(activityList); delete activityList; };
+    runBench("startActivities", &parameters, 1, nbEvents, newActivityList, [&]() { startActivities(processList, activityList); }, clearActivityList);
+    runBench("endActivities", &parameters, 1, nbEvents, newActivityList, [&]() { endActivities(processList, activityList); }, clearActivityList);
+
+    ProcessList * variantList = nullptr;
+    runBench("variants", &parameters, 1, nbEvents, [&]() { variantList = new ProcessList; }, [&]() { variants(processList, variantList); },
+             [&]() { clear(variantList); });
+    variantList = new ProcessList;
+    quiet([&]() { variants(processList, variantList); });
+    runBench("processAlreadyExists", &parameters, nbCases, nbEvents, []() {}, [&]() {
+        for (Process * ptr = processList->firstProcess; ptr != nullptr; ptr = ptr->nextProcess)
+            processAlreadyExists(variantList, ptr);
+    }, []() {});
+    clear(variantList);
+    clear(processList);
+    remove(fileName.c_str());
+    return 0;
+}
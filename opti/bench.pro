@@ -0,0 +1,14 @@
+TEMPLATE = app
+CONFIG += console c++17 thread
+CONFIG -= app_bundle
+CONFIG -= qt
+
+LIBS += -lz
+
+SOURCES += \
+        bench.cpp \
+        functions.cpp
+
+HEADERS += \
+    functions.h \
+    typeDef.h
@@ -10,6 +10,40 @@
 
 #include <iostream>
 #include <fstream>
+#include <filesystem>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <zlib.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define OPTI_X86_SIMD
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -40,21 +74,19 @@ double calculateDuration(chrono::time_point<std::chrono::high_resolution_clock>
  */
 
 /**
- * @brief Ouvre le fichier passer en paramètres et le parcours intégralement en comptant le nombre
- * de ligne. Le fichier est fermé avant de retourner le nombre de lignes trouvé.
+ * @brief Projette le fichier en mémoire (mapFile) et compte les fins de ligne avec countNewlines.
+ * Une dernière ligne sans retour à la ligne est comptée.
+ * La projection est libérée avant de retourner le nombre de lignes trouvé.
  */
 int nbOfLines(string aFileName)
 {
-    ifstream iFile(aFileName);
-    if (iFile.is_open())
+    MappedFile file;
+    if (mapFile(&file, aFileName))
     {
-        int nbLines = 0;
-        while (!iFile.eof())
-        {
-            iFile.ignore(256,'\n');
+        size_t nbLines = countNewlines(file.data, file.size);
+        if (file.size != 0 && file.data[file.size - 1] != '\n')
             nbLines++;
-        }
-        nbLines--;
+        unmapFile(&file);
         return nbLines;
     }
     else
@@ -106,6 +138,336 @@ void printProgressBar(int nb, int max)
 }
 
 
+/*
+ * Arena allocation
+ */
+
+static const size_t ARENA_FIRST_BLOCK = 64 << 10;
+static const size_t ARENA_MAX_BLOCK = 8 << 20;
+
+void enableArena(ProcessList * aList)
+{
+    if (aList->arena == nullptr)
+        aList->arena = new Arena;
+}
+
+/**
+ * @brief Réserve aSize octets (alignés) dans le bloc courant : simple incrément de used.
+ * Quand le bloc est plein un nouveau bloc deux fois plus grand est alloué (jusqu'à 8 Mo)
+ */
+static void * arenaAllocate(Arena * anArena, size_t aSize)
+{
+    const size_t alignment = alignof(max_align_t);
+    size_t start = (anArena->used + alignment - 1) & ~(alignment - 1);
+    if (anArena->current == nullptr || start + aSize > anArena->capacity)
+    {
+        size_t capacity = anArena->capacity == 0 ? ARENA_FIRST_BLOCK : anArena->capacity * 2;
+        if (capacity > ARENA_MAX_BLOCK)
+            capacity = ARENA_MAX_BLOCK;
+        if (capacity < aSize)
+            capacity = aSize;
+        anArena->current = new char[capacity];
+        anArena->blocks.push_back(anArena->current);
+        anArena->capacity = capacity;
+        start = 0;
+    }
+    anArena->used = start + aSize;
+    return anArena->current + start;
+}
+
+/**
+ * @brief Construit une activité dans l'arène, ou avec new si l'arène est nullptr
+ */
+static Activity * newActivity(Arena * anArena)
+{
+    if (anArena == nullptr)
+        return new Activity;
+    return new (arenaAllocate(anArena, sizeof(Activity))) Activity;
+}
+
+/**
+ * @brief Construit un processus dans l'arène de la liste (ou avec new) et lui associe l'arène
+ */
+static Process * newProcess(ProcessList * aList)
+{
+    Process * aProcess = aList->arena == nullptr ? new Process : new (arenaAllocate(aList->arena, sizeof(Process))) Process;
+    aProcess->arena = aList->arena;
+    aProcess->trie = aList->variantTrie;
+    return aProcess;
+}
+
+/**
+ * @brief Recopie le texte d'une date illisible. Dans une arène l'activité est mémorisée
+ * pour que sa chaîne soit détruite à la libération de l'arène
+ */
+static void keepTimeText(Arena * anArena, Activity * anActivity, const char * aText, size_t aLength)
+{
+    anActivity->time.assign(aText, aLength);
+    if (anArena != nullptr)
+        anArena->withText.push_back(anActivity);
+}
+
+void adoptArena(Arena * anArena, Arena * anOther)
+{
+    anArena->blocks.insert(anArena->blocks.end(), anOther->blocks.begin(), anOther->blocks.end());
+    anArena->withText.insert(anArena->withText.end(), anOther->withText.begin(), anOther->withText.end());
+    anOther->blocks.clear();
+    anOther->withText.clear();
+    anOther->current = nullptr;
+    anOther->used = 0;
+    anOther->capacity = 0;
+}
+
+/**
+ * @brief Détruit les seules activités qui possèdent une chaîne (dates illisibles), les autres nœuds
+ * n'ont rien à libérer, puis rend les blocs : le coût dépend du nombre de blocs, pas du nombre de nœuds
+ */
+void releaseArena(Arena * anArena)
+{
+    for (size_t i = 0; i < anArena->withText.size(); ++i)
+        anArena->withText[i]->~Activity();
+    for (size_t i = 0; i < anArena->blocks.size(); ++i)
+        delete[] anArena->blocks[i];
+    anArena->withText.clear();
+    anArena->blocks.clear();
+    anArena->current = nullptr;
+    anArena->used = 0;
+    anArena->capacity = 0;
+}
+
+
+/*
+ * Variant tracking
+ */
+
+/**
+ * @brief Cherche le fils de code aCode parmi les frères, le crée en tête de la liste des fils s'il n'existe pas
+ * (peu d'activités différentes : un parcours des frères suffit)
+ */
+static int trieChild(VariantTrie * aTrie, int aNode, int aCode)
+{
+    for (int child = aTrie->nodes[aNode].firstChild; child != -1; child = aTrie->nodes[child].nextSibling)
+        if (aTrie->nodes[child].code == aCode)
+            return child;
+    TrieNode aChild;
+    aChild.code = aCode;
+    aChild.parent = aNode;
+    aChild.nextSibling = aTrie->nodes[aNode].firstChild;
+    aTrie->nodes.push_back(aChild);     //nodes peut être réalloué : on passe par les index
+    int child = aTrie->nodes.size() - 1;
+    aTrie->nodes[aNode].firstChild = child;
+    return child;
+}
+
+/**
+ * @brief Ajoute aCount cas se terminant sur le nœud (frequency), le nœud est inscrit
+ * dans la liste des variants la première fois qu'un cas s'y termine.
+ * Le cas devient le représentant du nœud s'il n'en a pas (première fois, ou représentant parti)
+ */
+static void trieEnd(VariantTrie * aTrie, int aNode, int aCount, int aCaseId)
+{
+    TrieNode * node = &aTrie->nodes[aNode];
+    if (aCount <= 0)
+        return;
+    if (node->variantRank == -1)
+    {
+        node->variantRank = aTrie->variants.size();
+        node->firstCaseId = UNKNOWN_CASE_ID;
+        aTrie->variants.push_back(aNode);
+    }
+    if (node->firstCaseId == UNKNOWN_CASE_ID)
+        node->firstCaseId = aCaseId;
+    node->frequency += aCount;
+}
+
+/**
+ * @brief Le cas aCaseId ne se termine plus sur le nœud : s'il en était le représentant
+ * l'id est oublié, il sera remplacé au prochain trieEnd (ou retrouvé par trieVariants sur la liste)
+ */
+static void trieLeave(VariantTrie * aTrie, int aNode, int aCaseId)
+{
+    TrieNode * node = &aTrie->nodes[aNode];
+    node->frequency--;
+    if (node->firstCaseId == aCaseId)
+        node->firstCaseId = UNKNOWN_CASE_ID;
+}
+
+/**
+ * @brief Fait avancer un processus suivi dans l'arbre pour les activités de aFirst à la fin :
+ * le cas quitte son nœud (frequency) et traverse les fils (nbCases).
+ * aFirst est la première activité non comptée, si c'est la première du processus le cas part de la racine
+ */
+static void trieFollow(VariantTrie * aTrie, Process * aProcess, Activity * aFirst)
+{
+    int node = aProcess->trieNode;
+    if (aFirst == aProcess->firstActivity)
+    {
+        node = 0;
+        aTrie->nodes[0].nbCases++;
+    }
+    else
+        trieLeave(aTrie, node, aProcess->id);
+    for (Activity * activityPtr = aFirst; activityPtr != nullptr; activityPtr = activityPtr->nextActivity)
+    {
+        node = trieChild(aTrie, node, activityCode(activityPtr));
+        aTrie->nodes[node].nbCases++;
+    }
+    trieEnd(aTrie, node, 1, aProcess->id);
+    aProcess->trieNode = node;
+}
+
+/**
+ * @brief Ajoute l'activité en queue (push_back) puis met à jour l'empreinte du processus s'il est suivi
+ */
+static void appendActivity(Process * aProcess, Activity * anActivity)
+{
+    push_back(aProcess, anActivity);
+    if (aProcess->trie != nullptr)
+        trieFollow(aProcess->trie, aProcess, anActivity);
+}
+
+/**
+ * @brief Un arbre réduit à sa racine, les processus créés ensuite par newProcess le reçoivent
+ */
+void trackVariants(ProcessList * aList)
+{
+    if (aList->variantTrie != nullptr)
+        return;
+    aList->variantTrie = new VariantTrie;
+    aList->variantTrie->nodes.assign(1, TrieNode());
+}
+
+/**
+ * @brief Ajoute l'arbre d'une liste partielle à celui de la liste : les nœuds sont créés dans l'ordre
+ * des index (un parent a toujours un index plus petit que ses fils) et leurs compteurs ajoutés.
+ * aMap reçoit pour chaque nœud partiel l'index du nœud correspondant
+ */
+static void mergeTrie(VariantTrie * aTrie, VariantTrie * aPartial, vector<int> & aMap)
+{
+    aMap.assign(aPartial->nodes.size(), 0);
+    aTrie->nodes[0].nbCases += aPartial->nodes[0].nbCases;
+    for (size_t i = 1; i < aPartial->nodes.size(); ++i)
+    {
+        aMap[i] = trieChild(aTrie, aMap[aPartial->nodes[i].parent], aPartial->nodes[i].code);
+        aTrie->nodes[aMap[i]].nbCases += aPartial->nodes[i].nbCases;
+    }
+    for (size_t i = 0; i < aPartial->variants.size(); ++i)  //dans l'ordre d'apparition de la liste partielle
+    {
+        const TrieNode * node = &aPartial->nodes[aPartial->variants[i]];
+        trieEnd(aTrie, aMap[aPartial->variants[i]], node->frequency, node->firstCaseId);
+    }
+}
+
+
+/*
+ * Process index
+ */
+
+/**
+ * @brief Hachage de Fibonacci : les ids proches ou multiples d'une puissance de 2
+ * sont répartis sur toutes les cases
+ */
+static size_t indexSlot(const ProcessIndex * anIndex, int aProcessId)
+{
+    return (size_t)(((uint64_t)(uint32_t)aProcessId * 0x9E3779B97F4A7C15ull) >> 32) & (anIndex->capacity - 1);
+}
+
+/**
+ * @brief Ajoute un processus dans la première case libre à partir de sa case (sondage linéaire)
+ * la capacité doit être suffisante
+ */
+static void indexPlace(ProcessIndex * anIndex, Process * aProcess)
+{
+    size_t slot = indexSlot(anIndex, aProcess->id);
+    while (anIndex->processes[slot] != nullptr)
+        slot = (slot + 1) & (anIndex->capacity - 1);
+    anIndex->ids[slot] = aProcess->id;
+    anIndex->processes[slot] = aProcess;
+    anIndex->size++;
+}
+
+/**
+ * @brief Double la capacité (16 cases au départ) et replace tous les processus
+ */
+static void indexGrow(ProcessIndex * anIndex)
+{
+    int * oldIds = anIndex->ids;
+    Process ** oldProcesses = anIndex->processes;
+    size_t oldCapacity = anIndex->capacity;
+    anIndex->capacity = oldCapacity == 0 ? 16 : oldCapacity * 2;
+    anIndex->ids = new int[anIndex->capacity];
+    anIndex->processes = new Process *[anIndex->capacity]();
+    anIndex->size = 0;
+    for (size_t i = 0; i < oldCapacity; ++i)
+    {
+        if (oldProcesses[i] != nullptr)
+            indexPlace(anIndex, oldProcesses[i]);
+    }
+    delete[] oldIds;
+    delete[] oldProcesses;
+}
+
+/**
+ * @brief Ajoute un processus, en agrandissant la table au-delà d'un taux de remplissage de 1/2
+ */
+static void indexInsert(ProcessIndex * anIndex, Process * aProcess)
+{
+    if ((size_t)(anIndex->size + 1) * 2 > anIndex->capacity)
+        indexGrow(anIndex);
+    indexPlace(anIndex, aProcess);
+}
+
+/**
+ * @brief Libère les cases de l'index
+ */
+static void indexClear(ProcessIndex * anIndex)
+{
+    delete[] anIndex->ids;
+    delete[] anIndex->processes;
+    anIndex->ids = nullptr;
+    anIndex->processes = nullptr;
+    anIndex->capacity = 0;
+    anIndex->size = 0;
+    anIndex->version = -1;
+}
+
+/**
+ * @brief Reconstruit l'index à partir de la liste (liste construite ou modifiée sans push_front)
+ */
+static void indexRebuild(ProcessList * aList)
+{
+    indexClear(&aList->index);
+    for (Process * processPtr = aList->firstProcess; processPtr != nullptr; processPtr = processPtr->nextProcess)
+        indexInsert(&aList->index, processPtr);
+    aList->index.size = aList->size;    //une liste incohérente ne doit pas être reconstruite à chaque recherche
+    aList->index.version = aList->version;
+}
+
+/**
+ * @brief Vrai si l'index décrit la liste : même version et même taille
+ * (la taille rattrape une liste construite à la main sans changer la version)
+ */
+static bool indexUpToDate(const ProcessList * aList)
+{
+    return aList->index.version == aList->version && aList->index.size == aList->size;
+}
+
+/**
+ * @brief À appeler après l'ajout d'un processus dans la liste (size déjà incrémentée) : change la version de la liste,
+ * l'index n'est mis à jour que s'il était à jour avant l'ajout, sinon il sera reconstruit à la prochaine recherche
+ */
+static void indexAdded(ProcessList * aList, Process * aProcess)
+{
+    bool wasUpToDate = aList->index.version == aList->version && aList->index.size == aList->size - 1;
+    aList->version++;
+    if (wasUpToDate)
+    {
+        indexInsert(&aList->index, aProcess);
+        aList->index.version = aList->version;
+    }
+}
+
+
 /*
  * Utility functions for data structure
  */
@@ -114,28 +476,47 @@ void printProgressBar(int nb, int max)
  * @brief Parcours une liste de type Process afin de libérer la mémoire de toutes les activités
  * puis libère la mémoire de la liste de type Process
  * Chaque élément libéré est mis à pointer sur nullpointer
+ * (dans une arène les activités sont seulement décrochées, l'arène les libère)
  */
 void clear(Process * aList)
 {
+    if (aList->arena != nullptr)
+        aList->firstActivity = nullptr;
     while (aList->firstActivity != nullptr) {
         Activity * del = aList->firstActivity;
         aList->firstActivity = del->nextActivity;
         delete del;
     }
+    aList->lastActivity = nullptr;
 }
 
 /**
  * @brief Parcours tous les processus d'une liste et applique clear sur chaque processus
  * puis libère la mémoire de la liste et fait pointer la liste sur nullptr
+ * Si la liste a une arène, tout est libéré en une fois en rendant les blocs de l'arène
  */
 void clear(ProcessList * aList)
 {
+    if (aList->arena != nullptr)
+    {
+        releaseArena(aList->arena);
+        delete aList->arena;
+        aList->firstProcess = nullptr;
+        aList->Summary = nullptr;
+    }
     while (aList->firstProcess != nullptr) {
         Process * del = aList->firstProcess;
         aList->firstProcess = del->nextProcess;
         clear(del);
         delete del;
     }
+    while (aList->Summary != nullptr) {
+        SummaryCell * del = aList->Summary;
+        aList->Summary = del->nextSummary;
+        delete del;
+    }
+    indexClear(&aList->index);
+    delete aList->variantTrie;
     delete aList;
     aList = nullptr;
 }
@@ -152,7 +533,7 @@ void displayActivitiesList(Process * aProcess)
         string out = "";
         Activity *ptr = aProcess->firstActivity;
         for (int i = 0; i < aProcess->nbActivities; ++i) {
-            out += ptr->name + ' ';
+            out += getActivityName(ptr) + ' ';
             ptr = ptr->nextActivity;
         }
         cout<<"Nb activités : "<<aProcess->nbActivities<<": "<<out<<endl;
@@ -187,7 +568,8 @@ void displayProcessesList(ProcessList * aList) //on connait toute les taille ->
 
 /**
  * @brief Si la liste le processus ne contient aucune activité, l'activité est ajouté en tête
- * sinon la liste des activités est parcourue et l'activité est ajoutée en queue.
+ * sinon l'activité est ajoutée en queue : la liste est parcourue à partir de la dernière activité connue
+ * (lastActivity) ou de la première si elle est inconnue.
  * Le nombre d'activités du processus est incrémenté de 1
  */
 void push_back(Process * aProcess, Activity* anActivity)
@@ -196,28 +578,32 @@ void push_back(Process * aProcess, Activity* anActivity)
         aProcess->firstActivity = anActivity;
     else
     {
-        Activity * tracker = aProcess->firstActivity;
+        Activity * tracker = aProcess->lastActivity != nullptr ? aProcess->lastActivity : aProcess->firstActivity;
         while (tracker->nextActivity != nullptr)
             tracker = tracker->nextActivity;
         tracker->nextActivity = anActivity;
     }
+    aProcess->lastActivity = anActivity;
     aProcess->nbActivities++;
 }
 
 /**
  * @brief Construit un pointeur de type Activity et l'initialise au valeurs données
+ * (le nom est remplacé par son code dans le dictionnaire, la date par son timestamp)
  * puis utilise push_back pour ajouter l'activité à la fin de la liste (au processus)
  */
 void addActivity(Process * aProcess, string anActivityName, string aTime)
 {
-    Activity *anActivity = new Activity;
-    anActivity->name = anActivityName;
-    anActivity->time = aTime;
-    push_back(aProcess, anActivity);
+    Activity *anActivity = newActivity(aProcess->arena);
+    anActivity->code = internActivity(anActivityName);
+    if (!parseTimestamp(aTime.data(), aTime.size(), &anActivity->timestamp))
+        keepTimeText(aProcess->arena, anActivity, aTime.data(), aTime.size());   //date illisible : on garde le texte
+    appendActivity(aProcess, anActivity);
 }
 
 /**
  * @brief Ajoute un processus (Process) en tête de liste ProcessList
+ * et le référence dans l'index de la liste
  */
 void push_front(ProcessList * aList, Process * aProcess)
 {
@@ -229,6 +615,7 @@ void push_front(ProcessList * aList, Process * aProcess)
         aList->firstProcess = aProcess;
     }
     aList->size++;
+    indexAdded(aList, aProcess);
 }
 
 /**
@@ -238,26 +625,22 @@ void push_front(ProcessList * aList, Process * aProcess)
  */
 void addProcess(ProcessList * aList, int aProcessId, string anActivityName, string aTime)
 {
-    Process *aProcess = new Process;
+    Process *aProcess = newProcess(aList);
     aProcess->id = aProcessId;
     addActivity(aProcess, anActivityName, aTime);
     push_front(aList, aProcess);
 }
 
 /**
- * @brief Parcours la liste des processus
- * quand le processus est trouvé (comparaison des id à aProcessID) on utilise addActivity pour ajouter
+ * @brief Cherche le processus avec processExists (index)
+ * quand le processus est trouvé on utilise addActivity pour ajouter
  * l'activité donnée au processus trouvé
  */
 void insertProcessActivity(ProcessList * aList, int aProcessId, string anActivityName, string aTime)
 {
     if (aList->size != 0)
     {
-        Process * processPtr = aList->firstProcess;
-        while (processPtr != nullptr && processPtr->id != aProcessId) //tant que l'ID est différent et que le suivant existe, on parcours
-        {
-            processPtr = processPtr->nextProcess;
-        }
+        Process * processPtr = processExists(aList, aProcessId);
         if (processPtr == nullptr) //si le processus n'est pas trouvé, on le crée
             addProcess(aList,aProcessId,anActivityName,aTime);
         else
@@ -268,127 +651,407 @@ void insertProcessActivity(ProcessList * aList, int aProcessId, string anActivit
 }
 
 /**
- * @brief Parcours la liste des processus
+ * @brief Cherche l'id dans l'index de la liste (reconstruit d'abord s'il n'est plus à jour) :
+ * on part de la case de l'id et on avance jusqu'à trouver l'id ou une case vide
  * Si un processus correspond au process Id donné retourner un pointeur vers ce processus
  * retourne nullptr sinon
  */
 Process * processExists(ProcessList * aList, int aProcessId)
 {
-    Process * processPtr = aList->firstProcess;
-    while (processPtr != nullptr && processPtr->id != aProcessId) //tant que l'ID est différent et que le suivant existe, on parcours
+    if (!indexUpToDate(aList))
+        indexRebuild(aList);
+    const ProcessIndex * index = &aList->index;
+    if (index->capacity == 0)
+        return nullptr;
+    size_t slot = indexSlot(index, aProcessId);
+    while (index->processes[slot] != nullptr)
     {
-        processPtr = processPtr->nextProcess;
+        if (index->ids[slot] == aProcessId)
+            return index->processes[slot];
+        slot = (slot + 1) & (index->capacity - 1);
     }
-    return processPtr;//si le processus n'est pas trouvé, on renvoie nullptr,sinon, on retourne le pointeur
+    return nullptr;//si le processus n'est pas trouvé, on renvoie nullptr,sinon, on retourne le pointeur
 }
 
 
 /*
- * Processes Functions
+ * Activity dictionary
+ */
+
+/*
+ * Dictionnaire global : les noms dans l'ordre des codes et l'index nom -> code.
+ * Protégé par un verrou lecteurs/écrivain, chaque thread garde en plus un cache local
+ * (un code ne change jamais une fois attribué) pour éviter le verrou sur chaque événement.
+ * Les noms sont dans une deque (jamais déplacés) : l'index et les caches les désignent par des string_view
  */
+static deque<string> dictionaryNames;
+static unordered_map<string_view, int> dictionaryCodes;
+static shared_mutex dictionaryLock;
 
 /**
- * @brief Affiche la taille du fichier à analyser (en utilisant nbOfLines)
- * Puis parcours le fichier
- * met à jour la barre de progression en utilisant pringProgressBar
- * utilise cin pour récupérer l'identifiant du processus, le nom de l'activité et la date de l'activité
- * si le processus existe (id déjà présent, pour cela on utilise processExist)
- * l'activité est ajoutée au processus trouvé en utilisant insertProcessActivity
- * ajoute le processus à la liste des processus sinon en utilisant addProcess
- * Ne pas oublier de fermer le fichier
+ * @brief Cherche le nom dans le cache du thread, puis dans le dictionnaire (verrou partagé),
+ * enfin l'ajoute au dictionnaire (verrou exclusif) avec le code suivant.
+ * Seul l'ajout d'un nouveau nom alloue une string
  */
-void extractProcesses(ProcessList* aList, string aFileName)
+int internActivity(const char * aName, size_t aLength)
 {
-    int nbLines = nbOfLines(aFileName);
-    int nb100Lines = nbLines/100 +1;
-    cout<<"Début de l'analyse du fichier, "<<nbLines<<" lignes trouvés"<<endl;
-    ifstream iFile(aFileName);
-    if (iFile.is_open())
+    thread_local unordered_map<string_view, int> cache;
+    string_view name(aName, aLength);
+    unordered_map<string_view, int>::iterator cached = cache.find(name);
+    if (cached != cache.end())
+        return cached->second;
+    int code;
+    string_view stored;
     {
-        int id;
-        string name;
-        string time;
-        Process * ptr;
-        SummaryCell * summaryPtr = nullptr;
-        int iteration = 0;
-        while (iteration != nbLines) //(!iFile.eof())
-        {
-            iteration++;
-            if (iteration % nb100Lines == 0)
-                printProgressBar(iteration, nbLines);
-            if (iFile >> id >> name >> time)
-            {
-                ptr = processSummaryExists(aList,id);
-                if (ptr == nullptr)  //si le processus n'existe pas
-                {
-                    summaryPtr = summarySame(aList,id); //on teste si un sommaire du debut de l'id processus existe
-                    if (summaryPtr == nullptr)          //s'il n'existe pas, on crée le processus et le sommaire, et le sommaire pointe vers le processus
-                    {
-                        addProcess(aList,id,name,time);
-                        addSummary(aList,aList->firstProcess);
-                    }
-                    else                                // s'il existe, on crée le processus au bon sommaire(comme un livre à chapitre)
-                    {
-                        addProcessSummary(aList,id,name,time);
-                    }
-                }
-                else //si le processus existe déjà, on lui ajoute une activité
-                {
-                    addActivity(ptr,name,time);
-                }
-            }
-            else
-                cout<<"Erreur de lecture du fichier"<<endl;
-        }
-        printProgressBar(iteration, nbLines);
+        shared_lock<shared_mutex> readLock(dictionaryLock);
+        unordered_map<string_view, int>::iterator found = dictionaryCodes.find(name);
+        code = found != dictionaryCodes.end() ? found->second : -1;
+        if (code >= 0)
+            stored = found->first;
     }
-    else
+    if (code < 0)
     {
-        cout<<"Erreur d'ouverture du fichier"<<endl;
+        unique_lock<shared_mutex> writeLock(dictionaryLock);
+        unordered_map<string_view, int>::iterator found = dictionaryCodes.find(name);  //un autre thread a pu l'ajouter entre temps
+        if (found != dictionaryCodes.end())
+        {
+            code = found->second;
+            stored = found->first;
+        }
+        else
+        {
+            code = dictionaryNames.size();
+            dictionaryNames.emplace_back(aName, aLength);
+            stored = dictionaryNames.back();
+            dictionaryCodes.emplace(stored, code);
+        }
     }
-    iFile.close();
+    cache.emplace(stored, code);    //la clé désigne le nom du dictionnaire, pas celui de l'appelant
+    return code;
+}
+
+int internActivity(string anActivityName)
+{
+    return internActivity(anActivityName.data(), anActivityName.size());
+}
+
+string activityName(int aCode)
+{
+    shared_lock<shared_mutex> readLock(dictionaryLock);
+    if (aCode < 0 || aCode >= (int)dictionaryNames.size())
+        return "";
+    return dictionaryNames[aCode];
+}
+
+int nbActivityCodes()
+{
+    shared_lock<shared_mutex> readLock(dictionaryLock);
+    return dictionaryNames.size();
 }
 
 /**
- * @brief Initialise une variable somme
- * Parcours la liste des processus puis ajoute le nombre d'activité de chaque processus
- * à la variable somme
- * retourne la moyenne somme/nombre de processus en réel
+ * @brief Une activité construite à la main n'a qu'un nom : il est codé au premier accès
  */
-double averageProcessLength(ProcessList * aList)
+int activityCode(Activity * anActivity)
 {
-    double sum = 0;
-    double nbProcess = 0;
-    if (aList->size != 0)
-    {
-        Process * processPtr = aList->firstProcess;
-        while (processPtr->nextProcess != nullptr) {
-            sum += processPtr->nbActivities;
-            nbProcess++;
-            processPtr = processPtr->nextProcess;
-        }
-        sum += processPtr->nbActivities;
-        nbProcess++;
-    }
-    return sum / nbProcess;
+    if (anActivity->code < 0)
+        anActivity->code = internActivity(anActivity->name);
+    return anActivity->code;
 }
 
 /**
- * @brief Insère une activité dans un processus en respectant l'ordre croissant sur le nom des activités
- * et à condition que le nom de l'activité n'existe pas déjà
+ * @brief Le nom stocké s'il existe, sinon le nom du code dans le dictionnaire
  */
-void insertActivity(Process * aProcess, Activity* anActivity)
+string getActivityName(Activity * anActivity)
 {
-    aProcess->nbActivities++;
-    if (aProcess->firstActivity != nullptr)
+    if (!anActivity->name.empty() || anActivity->code < 0)
+        return anActivity->name;
+    return activityName(anActivity->code);
+}
+
+
+/*
+ * Timestamps
+ */
+
+static const char * const MONTHS[12] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+/**
+ * @brief Lit entre 1 et maxDigits chiffres (exactement maxDigits si isFixed)
+ */
+static bool readDigits(const char *& aCursor, const char * anEnd, int maxDigits, bool isFixed, int * aValue)
+{
+    int value = 0;
+    int nbDigits = 0;
+    while (aCursor != anEnd && nbDigits < maxDigits && *aCursor >= '0' && *aCursor <= '9')
     {
-        Activity * activityPtr = aProcess->firstActivity;
-        if (anActivity->name < activityPtr->name)   //si plus grand que la première activité
-        {
-            anActivity->nextActivity = aProcess->firstActivity;
+        value = value * 10 + (*aCursor - '0');
+        aCursor++;
+        nbDigits++;
+    }
+    *aValue = value;
+    return nbDigits != 0 && (!isFixed || nbDigits == maxDigits);
+}
+
+static void skipSeparators(const char *& aCursor, const char * anEnd)
+{
+    while (aCursor != anEnd && (*aCursor == '-' || *aCursor == ' '))
+        aCursor++;
+}
+
+/**
+ * @brief Nombre de jours depuis le 1970-01-01 d'une date du calendrier grégorien
+ * (algorithme days_from_civil de H. Hinnant)
+ */
+static int64_t daysFromCivil(int64_t aYear, int aMonth, int aDay)
+{
+    aYear -= aMonth <= 2;
+    int64_t era = (aYear >= 0 ? aYear : aYear - 399) / 400;
+    int64_t yearOfEra = aYear - era * 400;
+    int64_t dayOfYear = (153 * (aMonth + (aMonth > 2 ? -3 : 9)) + 2) / 5 + aDay - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * @brief Analyse HH:MM[:SS]
+ */
+static bool readClock(const char *& aCursor, const char * anEnd, int * anHour, int * aMinute, int * aSecond)
+{
+    *aSecond = 0;
+    if (!readDigits(aCursor, anEnd, 2, false, anHour) || aCursor == anEnd || *aCursor != ':')
+        return false;
+    aCursor++;
+    if (!readDigits(aCursor, anEnd, 2, true, aMinute))
+        return false;
+    if (aCursor != anEnd && *aCursor == ':')
+    {
+        aCursor++;
+        if (!readDigits(aCursor, anEnd, 2, true, aSecond))
+            return false;
+    }
+    return *anHour <= 24 && *aMinute <= 59 && *aSecond <= 60;
+}
+
+/**
+ * @brief Trois formats reconnus d'après le premier caractère et la forme du début :
+ * entier (secondes depuis l'époque), ISO-8601 (AAAA-MM-JJ...) ou ctime avec tirets (Fri-Feb--3-19:44:59-2023).
+ * Aucune allocation : le texte est lu caractère par caractère
+ */
+bool parseTimestamp(const char * aText, size_t aLength, int64_t * aTimestamp)
+{
+    const char * cursor = aText;
+    const char * end = aText + aLength;
+    if (aLength == 0)
+        return false;
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    int64_t offset = 0;
+
+    if ((*cursor >= 'A' && *cursor <= 'Z') || (*cursor >= 'a' && *cursor <= 'z'))   //ctime : Www-Mmm-JJ-HH:MM:SS-AAAA
+    {
+        if (aLength < 4)
+            return false;
+        cursor += 3;
+        skipSeparators(cursor, end);
+        if (end - cursor < 3)
+            return false;
+        for (int i = 0; i < 12 && month == 0; ++i)
+        {
+            if (cursor[0] == MONTHS[i][0] && cursor[1] == MONTHS[i][1] && cursor[2] == MONTHS[i][2])
+                month = i + 1;
+        }
+        if (month == 0)
+            return false;
+        cursor += 3;
+        skipSeparators(cursor, end);
+        if (!readDigits(cursor, end, 2, false, &day))
+            return false;
+        skipSeparators(cursor, end);
+        if (!readClock(cursor, end, &hour, &minute, &second))
+            return false;
+        skipSeparators(cursor, end);
+        if (!readDigits(cursor, end, 4, true, &year) || cursor != end)
+            return false;
+    }
+    else if (aLength >= 10 && aText[4] == '-')                                     //ISO-8601
+    {
+        if (!readDigits(cursor, end, 4, true, &year) || *cursor++ != '-'
+            || !readDigits(cursor, end, 2, true, &month) || cursor == end || *cursor++ != '-'
+            || !readDigits(cursor, end, 2, true, &day))
+            return false;
+        if (cursor != end && (*cursor == 'T' || *cursor == ' '))
+        {
+            cursor++;
+            if (!readClock(cursor, end, &hour, &minute, &second))
+                return false;
+            if (cursor != end && (*cursor == '.' || *cursor == ','))  //fraction de seconde ignorée
+            {
+                cursor++;
+                while (cursor != end && *cursor >= '0' && *cursor <= '9')
+                    cursor++;
+            }
+        }
+        if (cursor != end && *cursor == 'Z')
+            cursor++;
+        else if (cursor != end && (*cursor == '+' || *cursor == '-'))
+        {
+            int sign = *cursor == '-' ? -1 : 1;
+            int offsetHours = 0;
+            int offsetMinutes = 0;
+            cursor++;
+            if (!readDigits(cursor, end, 2, true, &offsetHours))
+                return false;
+            if (cursor != end && *cursor == ':')
+                cursor++;
+            if (cursor != end && !readDigits(cursor, end, 2, true, &offsetMinutes))
+                return false;
+            offset = sign * (offsetHours * 3600 + offsetMinutes * 60);
+        }
+        if (cursor != end)
+            return false;
+    }
+    else                                                                            //secondes depuis l'époque
+    {
+        bool isNegative = *cursor == '-';
+        if (*cursor == '-' || *cursor == '+')
+            cursor++;
+        if (cursor == end || end - cursor > 18)
+            return false;
+        int64_t value = 0;
+        while (cursor != end && *cursor >= '0' && *cursor <= '9')
+        {
+            value = value * 10 + (*cursor - '0');
+            cursor++;
+        }
+        if (cursor != end)
+            return false;
+        *aTimestamp = isNegative ? -value : value;
+        return true;
+    }
+
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+        return false;
+    *aTimestamp = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+    return true;
+}
+
+/**
+ * @brief Une activité construite à la main n'a que le texte : il est analysé au premier accès
+ */
+int64_t getActivityTimestamp(Activity * anActivity)
+{
+    if (anActivity->timestamp == NO_TIMESTAMP && !anActivity->time.empty())
+        parseTimestamp(anActivity->time.data(), anActivity->time.size(), &anActivity->timestamp);
+    return anActivity->timestamp;
+}
+
+
+/*
+ * Processes Functions
+ */
+
+/**
+ * @brief Affiche la taille du fichier à analyser (en utilisant nbOfLines)
+ * Puis parcours le fichier
+ * met à jour la barre de progression en utilisant pringProgressBar
+ * utilise cin pour récupérer l'identifiant du processus, le nom de l'activité et la date de l'activité
+ * si le processus existe (id déjà présent, pour cela on utilise processExist)
+ * l'activité est ajoutée au processus trouvé en utilisant insertProcessActivity
+ * ajoute le processus à la liste des processus sinon en utilisant addProcess
+ * Ne pas oublier de fermer le fichier
+ */
+void extractProcesses(ProcessList* aList, string aFileName)
+{
+    if (filesystem::is_directory(aFileName))
+    {
+        extractProcesses(aList, logSegments(aFileName), 0);
+        return;
+    }
+    if (isGzipFile(aFileName))
+    {
+        extractProcessesGzip(aList, aFileName);
+        return;
+    }
+    int nbLines = nbOfLines(aFileName);
+    int nb100Lines = nbLines/100 +1;
+    cout<<"Début de l'analyse du fichier, "<<nbLines<<" lignes trouvés"<<endl;
+    ifstream iFile(aFileName);
+    if (iFile.is_open())
+    {
+        int id;
+        string name;
+        string time;
+        int iteration = 0;
+        while (iteration != nbLines) //(!iFile.eof())
+        {
+            iteration++;
+            if (iteration % nb100Lines == 0)
+                printProgressBar(iteration, nbLines);
+            if (iFile >> id >> name >> time)
+                insertEvent(aList,id,name,time);
+            else
+                cout<<"Erreur de lecture du fichier"<<endl;
+        }
+        printProgressBar(iteration, nbLines);
+    }
+    else
+    {
+        cout<<"Erreur d'ouverture du fichier"<<endl;
+    }
+    iFile.close();
+}
+
+/**
+ * @brief Initialise une variable somme
+ * Parcours la liste des processus puis ajoute le nombre d'activité de chaque processus
+ * à la variable somme
+ * retourne la moyenne somme/nombre de processus en réel
+ */
+double averageProcessLength(ProcessList * aList)
+{
+    double sum = 0;
+    double nbProcess = 0;
+    if (aList->size != 0)
+    {
+        Process * processPtr = aList->firstProcess;
+        while (processPtr->nextProcess != nullptr) {
+            sum += processPtr->nbActivities;
+            nbProcess++;
+            processPtr = processPtr->nextProcess;
+        }
+        sum += processPtr->nbActivities;
+        nbProcess++;
+    }
+    return sum / nbProcess;
+}
+
+/**
+ * @brief Compare deux activités : 0 si elles ont le même code,
+ * sinon l'ordre de leurs noms (résolus dans le dictionnaire)
+ */
+static int compareActivities(Activity * anActivity, Activity * anOther)
+{
+    if (activityCode(anActivity) == activityCode(anOther))
+        return 0;
+    return getActivityName(anActivity).compare(getActivityName(anOther));
+}
+
+/**
+ * @brief Insère une activité dans un processus en respectant l'ordre croissant sur le nom des activités
+ * et à condition que l'activité (son code) n'existe pas déjà
+ */
+void insertActivity(Process * aProcess, Activity* anActivity)
+{
+    aProcess->nbActivities++;
+    if (aProcess->firstActivity != nullptr)
+    {
+        Activity * activityPtr = aProcess->firstActivity;
+        if (compareActivities(anActivity, activityPtr) < 0)   //si plus grand que la première activité
+        {
+            anActivity->nextActivity = aProcess->firstActivity;
             aProcess->firstActivity = anActivity;
         }
-        else if (anActivity->name == activityPtr->name)  //si identique
+        else if (activityCode(anActivity) == activityCode(activityPtr))  //si identique
         {
             aProcess->nbActivities--;
         }
@@ -398,16 +1061,16 @@ void insertActivity(Process * aProcess, Activity* anActivity)
                 activityPtr->nextActivity = anActivity;
             else
             {
-                while (anActivity->name > activityPtr->nextActivity->name && activityPtr->nextActivity->nextActivity != nullptr) //tant que le nom est plus petit et que le suivant existe, on parcours
+                while (compareActivities(anActivity, activityPtr->nextActivity) > 0 && activityPtr->nextActivity->nextActivity != nullptr) //tant que le nom est plus petit et que le suivant existe, on parcours
                 {
                     activityPtr = activityPtr->nextActivity;
                 }
-                if (anActivity->name < activityPtr->nextActivity->name)  //si l'activité est plus petite
+                if (compareActivities(anActivity, activityPtr->nextActivity) < 0)  //si l'activité est plus petite
                 {
                     anActivity->nextActivity = activityPtr->nextActivity;   //on racroche le suivant à notre activité
                     activityPtr->nextActivity = anActivity;                 //on ajoute notre activité à la liste
                 }
-                else if (anActivity->name == activityPtr->nextActivity->name)   //si identique
+                else if (activityCode(anActivity) == activityCode(activityPtr->nextActivity))   //si identique
                 {
                     aProcess->nbActivities--;
                 }
@@ -421,43 +1084,46 @@ void insertActivity(Process * aProcess, Activity* anActivity)
 }
 
 /**
- * @brief Parcours la liste des processus
- * ajoute la première activité de chaque processus en utilisant
- * insertActivity (pas de doublons)
+ * @brief Ajoute à la liste d'activités une copie de chaque code compté au moins une fois,
+ * avec insertActivity pour respecter l'ordre des noms
  */
-void startActivities(ProcessList * aProcessList, Process * anActivityList)
+static void insertCountedActivities(const vector<int> & aCounts, Process * anActivityList)
 {
-        Process * processPtr = aProcessList->firstProcess;
-        while (processPtr != nullptr) {       //tant que l'élément suivant existe : ajouté la première activité à activityList et passer au suivant;
-            insertActivity(anActivityList,processPtr->firstActivity);
-            processPtr = processPtr->nextProcess;
+    for (size_t code = 0; code < aCounts.size(); ++code)
+    {
+        if (aCounts[code] > 0)
+        {
+            Activity * anActivity = new Activity;
+            anActivity->code = code;
+            insertActivity(anActivityList, anActivity);
         }
+    }
 }
 
 /**
- * @brief Parcours la liste des processus
- * Parcours la liste des activité de chaque processus
- * ajoute la dernière activité de chaque processus en utilisant
- * insertActivity (pas de doublons)
+ * @brief Compte la première activité de chaque processus (startEndHistograms, un seul parcours)
+ * puis ajoute une copie de chaque activité comptée en utilisant
+ * insertActivity (pas de doublons, les activités des processus ne sont pas partagées)
+ */
+void startActivities(ProcessList * aProcessList, Process * anActivityList)
+{
+    vector<int> starts;
+    vector<int> ends;
+    startEndHistograms(aProcessList, &starts, &ends);
+    insertCountedActivities(starts, anActivityList);
+}
+
+/**
+ * @brief Compte la dernière activité de chaque processus (startEndHistograms : lastActivity,
+ * sans parcourir les activités) puis ajoute une copie de chaque activité comptée en utilisant
+ * insertActivity (pas de doublons, une seule copie par activité)
  */
 void endActivities(ProcessList * aProcessList, Process * anActivityList)
 {
-    if (aProcessList->firstProcess != nullptr)
-    {
-        Process * processPtr = aProcessList->firstProcess;
-        Activity * activityPtr;
-        while (processPtr != nullptr) { //tant que le processus suivant existe, parcourir les activités jusqu'a la dernière, créer une copie et l'insérer
-            activityPtr = processPtr->firstActivity;
-            while (activityPtr->nextActivity != nullptr) {
-                activityPtr = activityPtr->nextActivity;
-            }
-            Activity *anActivity = new Activity;
-            anActivity->name = activityPtr->name;
-            anActivity->time = activityPtr->time;
-            insertActivity(anActivityList,anActivity);
-            processPtr = processPtr->nextProcess;
-        }
-    }
+    vector<int> starts;
+    vector<int> ends;
+    startEndHistograms(aProcessList, &starts, &ends);
+    insertCountedActivities(ends, anActivityList);
 }
 
 /**
@@ -484,7 +1150,7 @@ bool processAlreadyExists(ProcessList * aProcessList, Process * aProcess)
                 isIdentic = true;
                 for (int i = 0; i < aProcess->nbActivities; ++i)
                 {   //parcourir tout les activités en comparant avec le process donné, si différent passé au process suivant
-                    if (activityPtr->name != ptrAProcessActivities->name)
+                    if (activityCode(activityPtr) != activityCode(ptrAProcessActivities))
                     {
                         isIdentic = false;
                         break;
@@ -504,38 +1170,135 @@ bool processAlreadyExists(ProcessList * aProcessList, Process * aProcess)
         return false;
 }
 
+/**
+ * @brief Case de la table des variants : empreinte de la séquence, variant trouvé
+ * et numéro du cas qui l'a créé (utilisé par la version EventStore)
+ */
+struct VariantSlot
+{
+    uint64_t hash;
+    Process * variant;
+    int firstCase;
+};
+
+/**
+ * @brief Ajoute un code à l'empreinte d'une séquence (multiplication puis mélange des bits)
+ * l'empreinte d'une séquence se calcule activité par activité, dans l'ordre
+ */
+static uint64_t hashStep(uint64_t aHash, int aCode)
+{
+    aHash = (aHash ^ (uint32_t)aCode) * 0x9E3779B97F4A7C15ull;
+    return aHash ^ (aHash >> 29);
+}
+
+/**
+ * @brief Cherche la séquence d'empreinte aHash dans la table (adressage ouvert, sondage linéaire)
+ * isSame compare la séquence à celle d'une case de même empreinte.
+ * Renvoie la case trouvée, ou la case vide où l'ajouter (variant à nullptr)
+ */
+template <typename Compare>
+static VariantSlot * findVariant(vector<VariantSlot> & aTable, uint64_t aHash, Compare isSame)
+{
+    size_t mask = aTable.size() - 1;
+    for (size_t i = aHash & mask; ; i = (i + 1) & mask)
+    {
+        VariantSlot * slot = &aTable[i];
+        if (slot->variant == nullptr || (slot->hash == aHash && isSame(slot)))
+            return slot;
+    }
+}
+
+/**
+ * @brief Double la table quand elle est à moitié pleine et replace les variants
+ */
+static void growVariantTable(vector<VariantSlot> & aTable, size_t aNbVariants)
+{
+    if (aNbVariants * 2 < aTable.size())
+        return;
+    vector<VariantSlot> table(aTable.size() * 2, VariantSlot{0, nullptr, 0});
+    size_t mask = table.size() - 1;
+    for (size_t i = 0; i < aTable.size(); ++i)
+        if (aTable[i].variant != nullptr)
+        {
+            size_t j = aTable[i].hash & mask;
+            while (table[j].variant != nullptr)
+                j = (j + 1) & mask;
+            table[j] = aTable[i];
+        }
+    aTable.swap(table);
+}
+
+/**
+ * @brief Compare les codes de deux séquences de même longueur
+ */
+static bool sameSequence(Process * aProcess, Process * anOther)
+{
+    if (aProcess->nbActivities != anOther->nbActivities)
+        return false;
+    Activity * activityPtr = aProcess->firstActivity;
+    Activity * otherPtr = anOther->firstActivity;
+    while (activityPtr != nullptr && otherPtr != nullptr)
+    {
+        if (activityCode(activityPtr) != activityCode(otherPtr))
+            return false;
+        activityPtr = activityPtr->nextActivity;
+        otherPtr = otherPtr->nextActivity;
+    }
+    return activityPtr == otherPtr;
+}
+
 /**
  * @brief Parcours la liste des processus
  * affiche la barre de progression en utilisant pringProgressBar
- * pour chaque processus vérifie qu'il n'est pas déjà dans la lite des variants
- * (utilise processAlreadyExists)
+ * pour chaque processus calcule l'empreinte de sa séquence d'activités et la cherche
+ * dans une table de hachage des variants (au lieu de comparer à tous les variants avec processAlreadyExists),
+ * seules les séquences de même empreinte sont comparées activité par activité
  * si c'est un nouveau variant créer un nouveau processus
- * y ajouter toutes les activités en utilisant addActivity
+ * y ajouter toutes les activités
  * puis utiliser push_front pour ajouter le processus à la liste des variants
+ * sinon incrémenter le nombre de cas (frequency) du variant
  */
 void variants(ProcessList * aProcessList, ProcessList * aVariant)
 {
     int nb100process = aProcessList->size/100 + 1;
     int iteration = 0;
     cout<<"Début de l'analyse des variants, "<<aProcessList->size<<" processus trouvés"<<endl;
+    vector<VariantSlot> table(16, VariantSlot{0, nullptr, 0});
+    size_t nbVariants = 0;
     Process * processPtr = aProcessList->firstProcess;
-    while (processPtr->nextProcess != nullptr)
+    while (processPtr != nullptr)
     {
-        if (iteration % nb100process == 0)
+        if (iteration % nb100process == 0 && aProcessList->size != 0)    //printProgressBar divise par size
             printProgressBar(iteration,aProcessList->size);
         iteration++;
-        if (!processAlreadyExists(aVariant,processPtr))
+        uint64_t hash = 0;
+        for (Activity * activityPtr = processPtr->firstActivity; activityPtr != nullptr; activityPtr = activityPtr->nextActivity)
+            hash = hashStep(hash, activityCode(activityPtr));
+        VariantSlot * slot = findVariant(table, hash, [processPtr](VariantSlot * aSlot) {
+            return sameSequence(aSlot->variant, processPtr);
+        });
+        if (slot->variant == nullptr)
         {
-            Process *aProcess = new Process;
+            Process *aProcess = newProcess(aVariant);
             aProcess->id = processPtr->id;
             for (Activity * activityPtr = processPtr->firstActivity; activityPtr != nullptr; activityPtr = activityPtr->nextActivity) {
-                addActivity(aProcess, activityPtr->name, "0");
+                Activity * aCopy = newActivity(aVariant->arena);    //copie du code seulement, pas du nom
+                aCopy->code = activityCode(activityPtr);
+                aCopy->timestamp = 0;
+                push_back(aProcess, aCopy);
             }
             push_front(aVariant, aProcess);
+            slot->hash = hash;
+            slot->variant = aProcess;
+            aProcess->frequency = 1;
+            growVariantTable(table, ++nbVariants);  //slot n'est plus valide après
         }
+        else
+            slot->variant->frequency++;
         processPtr = processPtr->nextProcess;
     }
-    printProgressBar(aProcessList->size,aProcessList->size);
+    if (aProcessList->size != 0)
+        printProgressBar(aProcessList->size,aProcessList->size);
     cout<<aVariant->size<<" variants trouvés"<<endl;
 }
 
@@ -548,7 +1311,7 @@ void variants(ProcessList * aProcessList, ProcessList * aVariant)
  */
 void addSummary(ProcessList * aList, Process * aProcess)
 {
-    SummaryCell * aSummaryCell = new SummaryCell;
+    SummaryCell * aSummaryCell = aList->arena == nullptr ? new SummaryCell : new (arenaAllocate(aList->arena, sizeof(SummaryCell))) SummaryCell;
     aSummaryCell->id = firstNumberId(aProcess->id);
     aSummaryCell->firstProcess = aProcess;
     if (aList->Summary != nullptr) //ajoute le sommaire au début
@@ -572,6 +1335,7 @@ void pushSummaryFront(ProcessList * aList, Process * aProcess)
     aProcess->nextProcess = summary->firstProcess->nextProcess;
     summary->firstProcess->nextProcess = aProcess;
     aList->size++;
+    indexAdded(aList, aProcess);
 }
 
 /**
@@ -592,33 +1356,14 @@ SummaryCell * summarySame(ProcessList * aList, int aProcessId)
 }
 
 /**
- * Cherche si le processus existe déjà dans la liste donné comme processExists mais voyage par Sommaire(Summary).
+ * Cherche si le processus existe déjà dans la liste donné comme processExists.
+ * Les sommaires regroupaient les ids par firstNumberId (id/100000) : avec des ids inférieurs à 100000
+ * tout tombait dans le sommaire 0 et la recherche redevenait linéaire. La recherche passe donc par l'index.
  * Renvoie le pointeur du processus ou nullptr s'il n'existe pas
  */
 Process * processSummaryExists(ProcessList * aList, int aProcessId)
 {
-    SummaryCell * summary = summarySame(aList, aProcessId);  //crée le pointeur
-    if (summary == nullptr)  //si pas de sommaire
-    {
-        return nullptr;
-    }
-    else
-    {
-        Process * processPtr = summary->firstProcess;  //pointeur de processus
-        //tant que le processus pointé existe et qu'il commence par le même id que le sommaire et qu'il n'existe pas déjà, alors on passe au suivant
-        while (processPtr != nullptr && firstNumberId(processPtr->id) == summary->id && processPtr->id != aProcessId)
-        {
-            processPtr = processPtr->nextProcess;
-        }
-        if (processPtr == nullptr || firstNumberId(processPtr->id) != summary->id)
-        {
-            return nullptr;
-        }
-        else if (processPtr->id == aProcessId) //si processus identique(même), alors on renvoie son adresse
-        {
-            return processPtr;
-        }
-    }
+    return processExists(aList, aProcessId);
 }
 
 /**
@@ -640,7 +1385,7 @@ int firstNumberId(int aProcessId)
  */
 void addProcessSummary(ProcessList * aList, int aProcessId, string anActivityName, string aTime)
 {
-    Process *aProcess = new Process;
+    Process *aProcess = newProcess(aList);
     aProcess->id = aProcessId;
     addActivity(aProcess, anActivityName, aTime);
     pushSummaryFront(aList, aProcess);
@@ -661,3 +1406,2961 @@ void displaySummary(ProcessList * aList)
     }
     cout<<"nullptr"<<endl<<"#======#   End   #======#"<<endl<<endl;
 }
+
+
+/*
+ * Columnar event store
+ */
+
+/**
+ * @brief Premier parcours pour dimensionner les tableaux (nombre de cas et d'événements),
+ * second parcours pour recopier les ids, les codes et les timestamps de chaque processus à la suite
+ */
+void buildEventStore(ProcessList * aList, EventStore * aStore)
+{
+    size_t nbEvents = 0;
+    int nbProcesses = 0;
+    for (Process * processPtr = aList->firstProcess; processPtr != nullptr; processPtr = processPtr->nextProcess)
+    {
+        nbEvents += processPtr->nbActivities;
+        nbProcesses++;
+    }
+    aStore->ids.clear();
+    aStore->offsets.clear();
+    aStore->codes.clear();
+    aStore->timestamps.clear();
+    aStore->ids.reserve(nbProcesses);
+    aStore->offsets.reserve(nbProcesses + 1);
+    aStore->codes.reserve(nbEvents);
+    aStore->timestamps.reserve(nbEvents);
+    aStore->offsets.push_back(0);
+    for (Process * processPtr = aList->firstProcess; processPtr != nullptr; processPtr = processPtr->nextProcess)
+    {
+        aStore->ids.push_back(processPtr->id);
+        for (Activity * activityPtr = processPtr->firstActivity; activityPtr != nullptr; activityPtr = activityPtr->nextActivity)
+        {
+            aStore->codes.push_back(activityCode(activityPtr));
+            aStore->timestamps.push_back(getActivityTimestamp(activityPtr));
+        }
+        aStore->offsets.push_back(aStore->codes.size());
+    }
+}
+
+int nbCases(const EventStore * aStore)
+{
+    return aStore->ids.size();
+}
+
+int caseLength(const EventStore * aStore, int aCase)
+{
+    return aStore->offsets[aCase + 1] - aStore->offsets[aCase];
+}
+
+const int * caseActivities(const EventStore * aStore, int aCase)
+{
+    return aStore->codes.data() + aStore->offsets[aCase];
+}
+
+const int64_t * caseTimestamps(const EventStore * aStore, int aCase)
+{
+    return aStore->timestamps.data() + aStore->offsets[aCase];
+}
+
+/**
+ * @brief Le nombre total d'événements est la dernière borne : aucun parcours nécessaire
+ */
+double averageProcessLength(const EventStore * aStore)
+{
+    return (double)aStore->codes.size() / nbCases(aStore);
+}
+
+/**
+ * @brief Compte le premier code de chaque cas, puis insère une seule copie par code compté
+ * (pas de copies en double à libérer)
+ */
+void startActivities(const EventStore * aStore, Process * anActivityList)
+{
+    vector<int> starts(nbActivityCodes(), 0);
+    for (int i = 0; i < nbCases(aStore); ++i)
+    {
+        if (caseLength(aStore, i) != 0)
+            starts[caseActivities(aStore, i)[0]]++;
+    }
+    insertCountedActivities(starts, anActivityList);
+}
+
+/**
+ * @brief Même principe que startActivities : le dernier code d'un cas est juste avant la borne suivante
+ */
+void endActivities(const EventStore * aStore, Process * anActivityList)
+{
+    vector<int> ends(nbActivityCodes(), 0);
+    for (int i = 0; i < nbCases(aStore); ++i)
+    {
+        if (caseLength(aStore, i) != 0)
+            ends[aStore->codes[aStore->offsets[i + 1] - 1]]++;
+    }
+    insertCountedActivities(ends, anActivityList);
+}
+
+/**
+ * @brief Parcours les cas, l'empreinte de chaque cas est cherchée dans la table des variants,
+ * un variant de même empreinte est comparé au cas qui l'a créé en comparant les tableaux de codes
+ * contigus (memcmp) au lieu de parcourir des listes chaînées.
+ * Un nouveau variant est recopié dans la liste des variants avec push_front
+ */
+void variants(const EventStore * aStore, ProcessList * aVariant)
+{
+    vector<VariantSlot> table(16, VariantSlot{0, nullptr, 0});
+    size_t nbVariants = 0;
+    for (int i = 0; i < nbCases(aStore); ++i)
+    {
+        int length = caseLength(aStore, i);
+        const int * codes = caseActivities(aStore, i);
+        uint64_t hash = 0;
+        for (int j = 0; j < length; ++j)
+            hash = hashStep(hash, codes[j]);
+        VariantSlot * slot = findVariant(table, hash, [aStore, length, codes](VariantSlot * aSlot) {
+            return caseLength(aStore, aSlot->firstCase) == length
+                   && memcmp(caseActivities(aStore, aSlot->firstCase), codes, length * sizeof(int)) == 0;
+        });
+        if (slot->variant != nullptr)
+            slot->variant->frequency++;
+        else
+        {
+            Process * aProcess = newProcess(aVariant);
+            aProcess->id = aStore->ids[i];
+            for (int j = 0; j < length; ++j)
+            {
+                Activity * anActivity = newActivity(aVariant->arena);
+                anActivity->code = codes[j];
+                anActivity->timestamp = 0;
+                push_back(aProcess, anActivity);
+            }
+            push_front(aVariant, aProcess);
+            aProcess->frequency = 1;
+            *slot = VariantSlot{hash, aProcess, i};
+            growVariantTable(table, ++nbVariants);
+        }
+    }
+}
+
+/*
+ * Memory-mapped ingestion
+ */
+
+/**
+ * @brief Ouvre le fichier et le projette en mémoire en lecture seule (mmap)
+ * le noyau charge les pages à la demande, aucune copie dans un buffer utilisateur.
+ * Sous Windows le fichier est lu en une fois dans un buffer alloué.
+ * Un fichier vide est accepté (data reste à nullptr, size à 0)
+ */
+bool mapFile(MappedFile * aFile, string aFileName)
+{
+    aFile->data = nullptr;
+    aFile->size = 0;
+    aFile->fd = -1;
+#ifdef _WIN32
+    ifstream iFile(aFileName, ios::binary | ios::ate);
+    if (!iFile.is_open())
+        return false;
+    aFile->size = iFile.tellg();
+    if (aFile->size != 0)
+    {
+        char * buffer = new char[aFile->size];
+        iFile.seekg(0);
+        iFile.read(buffer, aFile->size);
+        aFile->data = buffer;
+    }
+    return true;
+#else
+    int fd = open(aFileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    aFile->fd = fd;
+    aFile->size = fileStat.st_size;
+    if (aFile->size != 0)
+    {
+        void * data = mmap(nullptr, aFile->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            aFile->fd = -1;
+            aFile->size = 0;
+            return false;
+        }
+        madvise(data, aFile->size, MADV_SEQUENTIAL);  //lecture linéaire : le noyau lit en avance
+        aFile->data = (const char *)data;
+    }
+    return true;
+#endif
+}
+
+/**
+ * @brief Libère la projection (ou le buffer sous Windows) et ferme le fichier
+ */
+void unmapFile(MappedFile * aFile)
+{
+#ifdef _WIN32
+    delete[] aFile->data;
+#else
+    if (aFile->data != nullptr)
+        munmap((void *)aFile->data, aFile->size);
+    if (aFile->fd >= 0)
+        close(aFile->fd);
+#endif
+    aFile->data = nullptr;
+    aFile->size = 0;
+    aFile->fd = -1;
+}
+
+/**
+ * @brief Découpe la ligne courante en trois jetons (id, activité, date) comme le ferait
+ * iFile >> id >> name >> time, mais directement dans le buffer.
+ * Les blancs en début de ligne et les lignes vides sont ignorés.
+ * Le curseur est toujours placé au début de la ligne suivante, même si la ligne est invalide
+ */
+bool nextEvent(const char *& aCursor, const char * anEnd, EventToken * anEvent)
+{
+    while (aCursor != anEnd && (*aCursor == ' ' || *aCursor == '\t' || *aCursor == '\r' || *aCursor == '\n'))
+        aCursor++;
+    if (aCursor == anEnd)
+        return false;
+
+    bool isValid = parseId(aCursor, anEnd, &anEvent->id);
+
+    const char ** tokens[2] = {&anEvent->name, &anEvent->time};
+    size_t * lengths[2] = {&anEvent->nameLength, &anEvent->timeLength};
+    for (int i = 0; i < 2; ++i)    //nom de l'activité puis date
+    {
+        while (aCursor != anEnd && (*aCursor == ' ' || *aCursor == '\t'))
+            aCursor++;
+        const char * tokenStart = aCursor;
+        aCursor = findSeparator(aCursor, anEnd);
+        *tokens[i] = tokenStart;
+        *lengths[i] = aCursor - tokenStart;
+        if (*lengths[i] == 0)
+            isValid = false;
+    }
+
+    if (aCursor != anEnd && *aCursor != '\n')   //on se place sur la ligne suivante
+    {
+        const char * newline = (const char *)memchr(aCursor, '\n', anEnd - aCursor);
+        aCursor = newline == nullptr ? anEnd : newline;
+    }
+    if (aCursor != anEnd)
+        aCursor++;
+    return isValid;
+}
+
+/**
+ * @brief Vrai si la zone [begin, end[ ne contient que des blancs
+ */
+static bool isBlank(const char * aBegin, const char * anEnd)
+{
+    while (aBegin != anEnd && (*aBegin == ' ' || *aBegin == '\t' || *aBegin == '\r' || *aBegin == '\n'))
+        aBegin++;
+    return aBegin == anEnd;
+}
+
+/**
+ * @brief Code le nom (internActivity) et analyse la date (parseTimestamp) directement depuis les jetons,
+ * le texte de la date n'est copié que s'il est illisible
+ */
+Activity * makeActivity(ProcessList * aList, const EventToken * anEvent)
+{
+    Activity * anActivity = newActivity(aList->arena);
+    anActivity->code = internActivity(anEvent->name, anEvent->nameLength);
+    if (!parseTimestamp(anEvent->time, anEvent->timeLength, &anActivity->timestamp))
+        keepTimeText(aList->arena, anActivity, anEvent->time, anEvent->timeLength);
+    return anActivity;
+}
+
+/**
+ * @brief Construit l'activité comme addActivity puis l'ajoute avec insertEvent
+ */
+void insertEvent(ProcessList * aList, int aProcessId, string anActivityName, string aTime)
+{
+    Activity * anActivity = newActivity(aList->arena);
+    anActivity->code = internActivity(anActivityName);
+    if (!parseTimestamp(aTime.data(), aTime.size(), &anActivity->timestamp))
+        keepTimeText(aList->arena, anActivity, aTime.data(), aTime.size());
+    insertEvent(aList, aProcessId, anActivity);
+}
+
+/**
+ * @brief Cherche le processus dans l'index (processExists)
+ * s'il existe l'activité lui est ajoutée (push_back)
+ * sinon le processus est créé et ajouté en tête de liste (push_front)
+ */
+void insertEvent(ProcessList * aList, int aProcessId, Activity * anActivity)
+{
+    Process * ptr = processExists(aList,aProcessId);
+    if (ptr == nullptr)  //si le processus n'existe pas
+    {
+        Process * aProcess = newProcess(aList);
+        aProcess->id = aProcessId;
+        appendActivity(aProcess, anActivity);
+        push_front(aList, aProcess);
+    }
+    else //si le processus existe déjà, on lui ajoute une activité
+    {
+        appendActivity(ptr, anActivity);
+    }
+}
+
+/**
+ * @brief Projette le fichier en mémoire puis le parcours une seule fois :
+ * chaque ligne est découpée par nextEvent sans passer par les flux
+ * puis ajoutée à la liste par insertEvent (makeActivity).
+ * La barre de progression avance en fonction des octets lus (pas de comptage préalable des lignes)
+ */
+void extractProcessesMapped(ProcessList * aList, string aFileName)
+{
+    MappedFile file;
+    if (!mapFile(&file, aFileName))
+    {
+        cout<<"Erreur d'ouverture du fichier"<<endl;
+        return;
+    }
+    cout<<"Début de l'analyse du fichier, "<<file.size<<" octets"<<endl;
+    const char * begin = file.data;
+    const char * end = file.data + file.size;
+    const char * cursor = begin;
+    size_t step = file.size/100 + 1;
+    size_t nextStep = step;
+    EventToken event;
+    while (cursor != end)
+    {
+        const char * lineStart = cursor;
+        if (nextEvent(cursor, end, &event))
+        {
+            insertEvent(aList, event.id, makeActivity(aList, &event));
+        }
+        else if (!isBlank(lineStart, cursor))  //les blancs de fin de fichier ne sont pas des erreurs
+        {
+            cout<<"Erreur de lecture du fichier"<<endl;
+        }
+        if ((size_t)(cursor - begin) >= nextStep && cursor != end)
+        {
+            printProgressBar((cursor - begin) * 100 / file.size, 100);
+            nextStep += step;
+        }
+    }
+    printProgressBar(100, 100);
+    unmapFile(&file);
+}
+
+
+/*
+ * Parallel ingestion
+ */
+
+/**
+ * @brief Inverse la liste partielle pour retrouver l'ordre d'apparition des processus
+ * puis pour chaque processus :
+ * s'il existe déjà dans la liste (processExists) ses activités sont raccrochées en queue
+ * sinon le processus est déplacé en tête de liste comme dans insertEvent
+ */
+void mergeProcessLists(ProcessList * aList, ProcessList * aPartial)
+{
+    Process * reversed = nullptr;
+    while (aPartial->firstProcess != nullptr)
+    {
+        Process * next = aPartial->firstProcess->nextProcess;
+        aPartial->firstProcess->nextProcess = reversed;
+        reversed = aPartial->firstProcess;
+        aPartial->firstProcess = next;
+    }
+    aPartial->size = 0;
+    aPartial->version++;
+    indexClear(&aPartial->index);
+    if (aPartial->arena != nullptr)    //les nœuds déplacés restent dans les blocs de l'arène partielle
+    {
+        enableArena(aList);
+        adoptArena(aList->arena, aPartial->arena);
+    }
+    VariantTrie * trie = aList->variantTrie;
+    VariantTrie * partialTrie = aPartial->variantTrie;
+    vector<int> nodeMap;
+    if (trie != nullptr && partialTrie != nullptr)
+        mergeTrie(trie, partialTrie, nodeMap);
+
+    while (reversed != nullptr)
+    {
+        Process * aProcess = reversed;
+        reversed = reversed->nextProcess;
+        aProcess->nextProcess = nullptr;
+        Process * ptr = processExists(aList, aProcess->id);
+        if (ptr != nullptr)    //processus commencé dans un morceau précédent : on raccroche ses activités
+        {
+            if (aProcess->firstActivity != nullptr)
+            {
+                if (trie != nullptr && partialTrie != nullptr)  //le cas avait été compté comme un nouveau cas
+                {
+                    int node = nodeMap[aProcess->trieNode];
+                    trieLeave(trie, node, aProcess->id);
+                    for (; node != -1; node = trie->nodes[node].parent)
+                        trie->nodes[node].nbCases--;
+                }
+                Activity * spliced = aProcess->firstActivity;
+                int nbActivities = ptr->nbActivities + aProcess->nbActivities;
+                push_back(ptr, spliced);    //raccroche toute la chaîne
+                ptr->nbActivities = nbActivities;
+                ptr->lastActivity = aProcess->lastActivity;
+                if (trie != nullptr && ptr->trie == trie)
+                    trieFollow(trie, ptr, spliced);
+            }
+            if (aProcess->arena == nullptr)
+                delete aProcess;
+        }
+        else
+        {
+            if (aProcess->arena != nullptr)
+                aProcess->arena = aList->arena;
+            if (trie != nullptr && partialTrie != nullptr)
+                aProcess->trieNode = nodeMap[aProcess->trieNode];
+            else if (trie != nullptr && aProcess->firstActivity != nullptr)
+                trieFollow(trie, aProcess, aProcess->firstActivity);
+            aProcess->trie = trie;
+            push_front(aList, aProcess);
+        }
+    }
+}
+
+/**
+ * @brief Découpe la zone [begin, end[ avec nextEvent et ajoute les événements à une liste partielle
+ * avec insertEvent (chaque thread a sa liste et donc son index).
+ * Les octets traités sont ajoutés régulièrement à aProgress, les lignes invalides comptées dans aNbErrors
+ */
+static void parseRange(const char * aBegin, const char * anEnd, ProcessList * aPartial, atomic<size_t> * aProgress, int * aNbErrors)
+{
+    EventToken event;
+    const char * cursor = aBegin;
+    const char * reported = aBegin;
+    while (cursor != anEnd)
+    {
+        const char * lineStart = cursor;
+        if (nextEvent(cursor, anEnd, &event))
+        {
+            insertEvent(aPartial, event.id, makeActivity(aPartial, &event));
+        }
+        else if (!isBlank(lineStart, cursor))
+            (*aNbErrors)++;
+        if (cursor - reported >= (1 << 20))
+        {
+            *aProgress += cursor - reported;
+            reported = cursor;
+        }
+    }
+    *aProgress += cursor - reported;
+}
+
+/**
+ * @brief Projette le fichier en mémoire et le découpe en nbThreads morceaux
+ * (chaque frontière est avancée jusqu'au début de la ligne suivante)
+ * chaque morceau est analysé par parseRange sur son propre thread pendant que
+ * le thread principal affiche la progression,
+ * puis les listes partielles sont fusionnées dans l'ordre du fichier (mergeProcessLists)
+ */
+void extractProcessesParallel(ProcessList * aList, string aFileName, int nbThreads)
+{
+    if (nbThreads <= 0)
+        nbThreads = thread::hardware_concurrency();
+    if (nbThreads <= 0)
+        nbThreads = 1;
+    MappedFile file;
+    if (!mapFile(&file, aFileName))
+    {
+        cout<<"Erreur d'ouverture du fichier"<<endl;
+        return;
+    }
+    cout<<"Début de l'analyse du fichier, "<<file.size<<" octets, "<<nbThreads<<" threads"<<endl;
+    const char * end = file.data + file.size;
+    vector<const char *> bounds(nbThreads + 1, end);
+    bounds[0] = file.data;
+    for (int i = 1; i < nbThreads; ++i)
+    {
+        const char * bound = file.data + file.size / nbThreads * i;
+        if (bound < bounds[i - 1])
+            bound = bounds[i - 1];
+        while (bound != end && bound != file.data && *(bound - 1) != '\n')
+            bound++;
+        bounds[i] = bound;
+    }
+
+    vector<ProcessList *> partials(nbThreads);
+    vector<int> nbErrors(nbThreads, 0);
+    vector<thread> workers;
+    atomic<size_t> progress(0);
+    atomic<int> nbRunning(nbThreads);
+    for (int i = 0; i < nbThreads; ++i)
+    {
+        partials[i] = new ProcessList;
+        if (aList->arena != nullptr)
+            enableArena(partials[i]);
+        if (aList->variantTrie != nullptr)
+            trackVariants(partials[i]);
+        workers.emplace_back([&, i]() {
+            parseRange(bounds[i], bounds[i + 1], partials[i], &progress, &nbErrors[i]);
+            nbRunning--;
+        });
+    }
+    while (nbRunning > 0 && file.size != 0)
+    {
+        printProgressBar(progress * 99 / file.size, 100);
+        this_thread::sleep_for(chrono::milliseconds(100));
+    }
+    for (int i = 0; i < nbThreads; ++i)
+        workers[i].join();
+
+    int nbInvalid = 0;
+    for (int i = 0; i < nbThreads; ++i)
+    {
+        mergeProcessLists(aList, partials[i]);
+        clear(partials[i]);
+        nbInvalid += nbErrors[i];
+    }
+    printProgressBar(100, 100);
+    if (nbInvalid != 0)
+        cout<<"Erreur de lecture du fichier : "<<nbInvalid<<" lignes invalides"<<endl;
+    unmapFile(&file);
+}
+
+
+/*
+ * Streaming ingestion
+ */
+
+/**
+ * @brief Lit le flux par blocs de 1 Mo. Seules les lignes complètes d'un bloc (jusqu'au dernier '\n')
+ * sont découpées par nextEvent et ajoutées par insertEvent, la ligne incomplète est recopiée
+ * en tête du buffer pour être complétée par le bloc suivant (le buffer grandit si une ligne ne tient pas).
+ * Si la taille est connue la barre de progression suit les octets lus, sinon le nombre de Mo lus est affiché
+ */
+void extractProcessesStream(ProcessList * aList, istream & anInput, size_t anInputSize)
+{
+    if (anInputSize != 0)
+        cout<<"Début de l'analyse du flux, "<<anInputSize<<" octets"<<endl;
+    else
+        cout<<"Début de l'analyse du flux, taille inconnue"<<endl;
+    vector<char> buffer(1 << 20);
+    size_t pending = 0;                 //octets de la ligne incomplète en tête du buffer
+    size_t consumed = 0;
+    size_t step = anInputSize != 0 ? anInputSize/100 + 1 : 64 << 20;
+    size_t nextStep = step;
+    int nbInvalid = 0;
+    EventToken event;
+    bool isEnd = false;
+    while (!isEnd)
+    {
+        if (pending == buffer.size())   //ligne plus longue que le buffer
+            buffer.resize(buffer.size() * 2);
+        anInput.read(buffer.data() + pending, buffer.size() - pending);
+        size_t nbRead = anInput.gcount();
+        isEnd = nbRead == 0;
+        consumed += nbRead;
+        size_t filled = pending + nbRead;
+        const char * begin = buffer.data();
+        const char * end = begin + filled;
+        if (!isEnd)
+        {
+            while (end != begin && *(end - 1) != '\n')   //on s'arrête après la dernière ligne complète
+                end--;
+        }
+        const char * cursor = begin;
+        while (cursor != end)
+        {
+            const char * lineStart = cursor;
+            if (nextEvent(cursor, end, &event))
+            {
+                insertEvent(aList, event.id, makeActivity(aList, &event));
+            }
+            else if (!isBlank(lineStart, cursor))
+                nbInvalid++;
+        }
+        pending = begin + filled - end;
+        memmove(buffer.data(), end, pending);
+        if (consumed >= nextStep && !isEnd)
+        {
+            if (anInputSize != 0)
+                printProgressBar((consumed < anInputSize ? consumed : anInputSize) * 99 / anInputSize, 100);
+            else
+                cout<<'\r'<<(consumed >> 20)<<" Mo lus"<<flush;
+            nextStep += step;
+        }
+    }
+    if (anInputSize != 0)
+        printProgressBar(100, 100);
+    else
+        cout<<'\r'<<(consumed >> 20)<<" Mo lus"<<endl;
+    if (nbInvalid != 0)
+        cout<<"Erreur de lecture du fichier : "<<nbInvalid<<" lignes invalides"<<endl;
+}
+
+/**
+ * @brief Ouvre le fichier (ou utilise cin pour "-"), récupère sa taille si le flux le permet
+ * puis délègue à extractProcessesStream
+ */
+void extractProcessesStream(ProcessList * aList, string aFileName)
+{
+    if (aFileName == "-")
+    {
+        extractProcessesStream(aList, cin, 0);
+        return;
+    }
+    if (isGzipFile(aFileName))
+    {
+        extractProcessesGzip(aList, aFileName);
+        return;
+    }
+    ifstream iFile(aFileName, ios::binary);
+    if (iFile.is_open())
+    {
+        size_t size = 0;
+        iFile.seekg(0, ios::end);
+        streampos position = iFile.tellg();
+        if (position > 0)
+            size = position;
+        iFile.clear();
+        iFile.seekg(0, ios::beg);
+        iFile.clear();   //un tube n'accepte pas seekg : on lit depuis la position courante
+        extractProcessesStream(aList, iFile, size);
+    }
+    else
+    {
+        cout<<"Erreur d'ouverture du fichier"<<endl;
+    }
+    iFile.close();
+}
+
+/*
+ * Vectorized scanning
+ */
+
+/*
+ * Versions scalaires, utilisées pour les fins de buffer et quand le processeur n'a pas de SIMD
+ */
+static size_t countNewlinesScalar(const char * aData, size_t aSize)
+{
+    size_t nbLines = 0;
+    for (size_t i = 0; i < aSize; ++i)
+        nbLines += aData[i] == '\n';
+    return nbLines;
+}
+
+static const char * findSeparatorScalar(const char * aBegin, const char * anEnd)
+{
+    while (aBegin != anEnd && *aBegin != ' ' && *aBegin != '\t' && *aBegin != '\r' && *aBegin != '\n')
+        aBegin++;
+    return aBegin;
+}
+
+#ifdef OPTI_X86_SIMD
+/**
+ * @brief Compare 16 octets à la fois avec '\n', les résultats (-1 ou 0) sont soustraits
+ * d'un accumulateur d'octets vidé (psadbw) au plus toutes les 255 itérations
+ */
+__attribute__((target("sse2")))
+static size_t countNewlinesSse2(const char * aData, size_t aSize)
+{
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i zero = _mm_setzero_si128();
+    size_t nbLines = 0;
+    size_t i = 0;
+    while (aSize - i >= 16)
+    {
+        __m128i counters = zero;
+        size_t blockEnd = aSize - i >= 255 * 16 ? i + 255 * 16 : aSize;
+        for (; blockEnd - i >= 16; i += 16)
+            counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(aData + i)), newline));
+        __m128i sums = _mm_sad_epu8(counters, zero);
+        nbLines += _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums));
+    }
+    return nbLines + countNewlinesScalar(aData + i, aSize - i);
+}
+
+/**
+ * @brief Même principe que countNewlinesSse2 sur 32 octets
+ */
+__attribute__((target("avx2")))
+static size_t countNewlinesAvx2(const char * aData, size_t aSize)
+{
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i zero = _mm256_setzero_si256();
+    size_t nbLines = 0;
+    size_t i = 0;
+    while (aSize - i >= 32)
+    {
+        __m256i counters = zero;
+        size_t blockEnd = aSize - i >= 255 * 32 ? i + 255 * 32 : aSize;
+        for (; blockEnd - i >= 32; i += 32)
+            counters = _mm256_sub_epi8(counters, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(aData + i)), newline));
+        __m256i sums = _mm256_sad_epu8(counters, zero);
+        nbLines += _mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1)
+                 + _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3);
+    }
+    return nbLines + countNewlinesScalar(aData + i, aSize - i);
+}
+
+/**
+ * @brief Compare 16 octets à la fois avec les quatre séparateurs,
+ * le premier bit du masque donne la position du séparateur
+ */
+__attribute__((target("sse2")))
+static const char * findSeparatorSse2(const char * aBegin, const char * anEnd)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (anEnd - aBegin >= 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)aBegin);
+        __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, tab)),
+                                     _mm_or_si128(_mm_cmpeq_epi8(block, cr), _mm_cmpeq_epi8(block, newline)));
+        int mask = _mm_movemask_epi8(found);
+        if (mask != 0)
+            return aBegin + __builtin_ctz(mask);
+        aBegin += 16;
+    }
+    return findSeparatorScalar(aBegin, anEnd);
+}
+
+/**
+ * @brief Même principe que findSeparatorSse2 sur 32 octets
+ */
+__attribute__((target("avx2")))
+static const char * findSeparatorAvx2(const char * aBegin, const char * anEnd)
+{
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    while (anEnd - aBegin >= 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i *)aBegin);
+        __m256i found = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, space), _mm256_cmpeq_epi8(block, tab)),
+                                        _mm256_or_si256(_mm256_cmpeq_epi8(block, cr), _mm256_cmpeq_epi8(block, newline)));
+        unsigned int mask = _mm256_movemask_epi8(found);
+        if (mask != 0)
+            return aBegin + __builtin_ctz(mask);
+        aBegin += 32;
+    }
+    return findSeparatorSse2(aBegin, anEnd);
+}
+#endif
+
+/**
+ * @brief Niveau le plus élevé supporté par le processeur (détecté une seule fois)
+ */
+static int detectScannerLevel()
+{
+#ifdef OPTI_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return 2;
+    if (__builtin_cpu_supports("sse2"))
+        return 1;
+#endif
+    return 0;
+}
+
+static int maxScannerLevel = detectScannerLevel();
+static int currentScannerLevel = maxScannerLevel;
+
+int scannerLevel()
+{
+    return currentScannerLevel;
+}
+
+/**
+ * @brief Le niveau demandé est borné par ce que supporte le processeur
+ */
+int setScannerLevel(int aLevel)
+{
+    if (aLevel < 0)
+        aLevel = 0;
+    currentScannerLevel = aLevel < maxScannerLevel ? aLevel : maxScannerLevel;
+    return currentScannerLevel;
+}
+
+size_t countNewlines(const char * aData, size_t aSize)
+{
+#ifdef OPTI_X86_SIMD
+    if (currentScannerLevel == 2)
+        return countNewlinesAvx2(aData, aSize);
+    if (currentScannerLevel == 1)
+        return countNewlinesSse2(aData, aSize);
+#endif
+    return countNewlinesScalar(aData, aSize);
+}
+
+const char * findSeparator(const char * aBegin, const char * anEnd)
+{
+#ifdef OPTI_X86_SIMD
+    if (currentScannerLevel == 2)
+        return findSeparatorAvx2(aBegin, anEnd);
+    if (currentScannerLevel == 1)
+        return findSeparatorSse2(aBegin, anEnd);
+#endif
+    return findSeparatorScalar(aBegin, anEnd);
+}
+
+/**
+ * @brief Lit un signe optionnel puis les chiffres décimaux, sans passer par les flux
+ * (un id tient sur 10 chiffres au plus, une boucle scalaire suffit)
+ */
+bool parseId(const char *& aCursor, const char * anEnd, int * anId)
+{
+    bool isNegative = false;
+    if (aCursor != anEnd && (*aCursor == '-' || *aCursor == '+'))
+    {
+        isNegative = *aCursor == '-';
+        aCursor++;
+    }
+    const char * idStart = aCursor;
+    unsigned int id = 0;
+    while (aCursor != anEnd && (unsigned char)(*aCursor - '0') <= 9)
+    {
+        id = id * 10 + (*aCursor - '0');
+        aCursor++;
+    }
+    *anId = isNegative ? -(int)id : (int)id;
+    return aCursor != idStart;
+}
+
+
+/*
+ * Binary snapshots
+ */
+
+/**
+ * @brief Écrit un tableau puis complète avec des zéros jusqu'au multiple de 8 suivant,
+ * pour que chaque section du fichier projeté soit alignée
+ */
+static void writeSection(ofstream & anOutput, const void * aData, size_t aSize)
+{
+    static const char padding[8] = {0};
+    anOutput.write((const char *)aData, aSize);
+    anOutput.write(padding, (8 - aSize % 8) % 8);
+}
+
+/**
+ * @brief Renvoie la section de aSize octets qui commence au curseur et avance le curseur
+ * sur la section suivante, nullptr si le fichier est trop court
+ */
+static const char * readSection(const char *& aCursor, const char * anEnd, uint64_t aSize)
+{
+    uint64_t paddedSize = aSize + (8 - aSize % 8) % 8;
+    if (paddedSize < aSize || (uint64_t)(anEnd - aCursor) < paddedSize)
+        return nullptr;
+    const char * section = aCursor;
+    aCursor += paddedSize;
+    return section;
+}
+
+/**
+ * @brief Taille et date de modification du journal.
+ * Renvoie false si le fichier n'existe pas ou si l'une des deux ne peut pas être lue
+ */
+static bool sourceStamp(string aSourceName, uint64_t * aSize, int64_t * aTime)
+{
+    error_code error;
+    if (!filesystem::is_regular_file(aSourceName, error))
+        return false;
+    *aSize = filesystem::file_size(aSourceName, error);
+    if (error)
+        return false;
+    *aTime = filesystem::last_write_time(aSourceName, error).time_since_epoch().count();
+    return !error;
+}
+
+/**
+ * @brief Passe par buildEventStore pour obtenir les tableaux puis les écrit tels quels,
+ * seules les dates illisibles sont recopiées à part
+ */
+bool saveSnapshot(ProcessList * aList, string aFileName, string aSourceName)
+{
+    EventStore store;
+    buildEventStore(aList, &store);
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    if (!aSourceName.empty() && !sourceStamp(aSourceName, &header.sourceSize, &header.sourceTime))
+        return false;   //snapshot impossible à valider plus tard
+
+    //dictionnaire complet : les codes du fichier sont ceux du programme qui l'a écrit
+    vector<uint64_t> nameOffsets(1, 0);
+    string names;
+    for (int code = 0; code < nbActivityCodes(); ++code)
+    {
+        names += activityName(code);
+        nameOffsets.push_back(names.size());
+    }
+
+    vector<uint64_t> textEvents;
+    vector<uint64_t> textOffsets(1, 0);
+    string texts;
+    size_t event = 0;
+    for (Process * processPtr = aList->firstProcess; processPtr != nullptr; processPtr = processPtr->nextProcess)
+        for (Activity * activityPtr = processPtr->firstActivity; activityPtr != nullptr; activityPtr = activityPtr->nextActivity, ++event)
+            if (store.timestamps[event] == NO_TIMESTAMP)
+            {
+                textEvents.push_back(event);
+                texts += activityPtr->time;
+                textOffsets.push_back(texts.size());
+            }
+
+    header.nbNames = nameOffsets.size() - 1;
+    header.namesSize = names.size();
+    header.nbCases = store.ids.size();
+    header.nbEvents = store.codes.size();
+    //arbre suivi recopié tel quel : les variants garderont l'ordre dans lequel l'extraction les a rencontrés
+    const VariantTrie * trie = aList->variantTrie;
+    vector<int> caseNodes;
+    if (trie != nullptr)
+        for (Process * processPtr = aList->firstProcess; processPtr != nullptr; processPtr = processPtr->nextProcess)
+            caseNodes.push_back(processPtr->trie == trie ? processPtr->trieNode : 0);
+
+    header.nbTexts = textEvents.size();
+    header.textsSize = texts.size();
+    header.nbTrieNodes = trie != nullptr ? trie->nodes.size() : 0;
+    header.nbTrieVariants = trie != nullptr ? trie->variants.size() : 0;
+    vector<uint64_t> offsets(store.offsets.begin(), store.offsets.end());
+
+    ofstream oFile(aFileName, ios::binary | ios::trunc);
+    if (!oFile.is_open())
+        return false;
+    writeSection(oFile, &header, sizeof(header));
+    writeSection(oFile, nameOffsets.data(), nameOffsets.size() * sizeof(uint64_t));
+    writeSection(oFile, names.data(), names.size());
+    writeSection(oFile, store.ids.data(), store.ids.size() * sizeof(int));
+    writeSection(oFile, offsets.data(), offsets.size() * sizeof(uint64_t));
+    writeSection(oFile, store.codes.data(), store.codes.size() * sizeof(int));
+    writeSection(oFile, store.timestamps.data(), store.timestamps.size() * sizeof(int64_t));
+    writeSection(oFile, textEvents.data(), textEvents.size() * sizeof(uint64_t));
+    writeSection(oFile, textOffsets.data(), textOffsets.size() * sizeof(uint64_t));
+    writeSection(oFile, texts.data(), texts.size());
+    if (trie != nullptr)
+    {
+        writeSection(oFile, trie->nodes.data(), trie->nodes.size() * sizeof(TrieNode));
+        writeSection(oFile, trie->variants.data(), trie->variants.size() * sizeof(int));
+        writeSection(oFile, caseNodes.data(), caseNodes.size() * sizeof(int));
+    }
+    oFile.close();
+    return !oFile.fail();
+}
+
+/**
+ * @brief Vue sur les sections d'un snapshot projeté en mémoire (pointeurs dans le fichier)
+ */
+struct SnapshotView
+{
+    const SnapshotHeader * header;
+    const uint64_t * nameOffsets;
+    const char * names;
+    const int * ids;
+    const uint64_t * offsets;
+    const int * codes;
+    const int64_t * timestamps;
+    const uint64_t * textEvents;
+    const uint64_t * textOffsets;
+    const char * texts;
+    const TrieNode * trieNodes;
+    const int * trieVariants;
+    const int * caseNodes;
+    vector<int> codeMap;
+};
+
+/**
+ * @brief Vérifie l'arbre sauvegardé : liens dans le tableau, parent avant ses fils,
+ * codes dans le dictionnaire et rangs cohérents avec la liste des variants
+ */
+static bool checkSnapshotTrie(const SnapshotView * aView)
+{
+    const SnapshotHeader * header = aView->header;
+    int64_t nbNodes = header->nbTrieNodes;
+    int64_t nbVariants = header->nbTrieVariants;
+    if (nbNodes == 0)
+        return nbVariants == 0;
+    if (aView->trieNodes[0].parent != -1 || aView->trieNodes[0].code != -1)
+        return false;
+    for (int64_t i = 0; i < nbNodes; ++i)
+    {
+        const TrieNode & node = aView->trieNodes[i];
+        if ((i > 0 && (node.parent < 0 || node.parent >= i || node.code < 0 || (uint64_t)node.code >= header->nbNames))
+            || node.firstChild < -1 || node.firstChild >= nbNodes || node.nextSibling < -1 || node.nextSibling >= nbNodes
+            || node.variantRank < -1 || node.variantRank >= nbVariants)
+            return false;
+    }
+    for (int64_t i = 0; i < nbVariants; ++i)
+        if (aView->trieVariants[i] < 0 || aView->trieVariants[i] >= nbNodes || aView->trieNodes[aView->trieVariants[i]].variantRank != i)
+            return false;
+    for (uint64_t i = 0; i < header->nbCases; ++i)
+        if (aView->caseNodes[i] < 0 || aView->caseNodes[i] >= nbNodes)
+            return false;
+    return true;
+}
+
+/**
+ * @brief Vérifie l'en-tête, place les pointeurs sur les sections et contrôle que les offsets
+ * restent dans le fichier, puis traduit les codes du fichier vers le dictionnaire courant
+ */
+static bool openSnapshot(const MappedFile * aFile, string aSourceName, SnapshotView * aView)
+{
+    const char * cursor = aFile->data;
+    const char * end = aFile->data + aFile->size;
+    aView->header = (const SnapshotHeader *)readSection(cursor, end, sizeof(SnapshotHeader));
+    const SnapshotHeader * header = aView->header;
+    if (header == nullptr || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0
+        || header->version != SNAPSHOT_VERSION || header->byteOrder != SNAPSHOT_BYTE_ORDER)
+        return false;
+    if (!aSourceName.empty())  //le journal a changé depuis le snapshot
+    {
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        if (!sourceStamp(aSourceName, &sourceSize, &sourceTime) || sourceSize != header->sourceSize || sourceTime != header->sourceTime)
+            return false;
+    }
+    //tailles bornées par celle du fichier avant de multiplier
+    if (header->nbNames > aFile->size || header->nbCases > aFile->size || header->nbEvents > aFile->size || header->nbTexts > aFile->size
+        || header->nbTrieNodes > aFile->size || header->nbTrieVariants > aFile->size)
+        return false;
+    aView->nameOffsets = (const uint64_t *)readSection(cursor, end, (header->nbNames + 1) * sizeof(uint64_t));
+    aView->names = readSection(cursor, end, header->namesSize);
+    aView->ids = (const int *)readSection(cursor, end, header->nbCases * sizeof(int));
+    aView->offsets = (const uint64_t *)readSection(cursor, end, (header->nbCases + 1) * sizeof(uint64_t));
+    aView->codes = (const int *)readSection(cursor, end, header->nbEvents * sizeof(int));
+    aView->timestamps = (const int64_t *)readSection(cursor, end, header->nbEvents * sizeof(int64_t));
+    aView->textEvents = (const uint64_t *)readSection(cursor, end, header->nbTexts * sizeof(uint64_t));
+    aView->textOffsets = (const uint64_t *)readSection(cursor, end, (header->nbTexts + 1) * sizeof(uint64_t));
+    aView->texts = readSection(cursor, end, header->textsSize);
+    aView->trieNodes = (const TrieNode *)readSection(cursor, end, header->nbTrieNodes * sizeof(TrieNode));
+    aView->trieVariants = (const int *)readSection(cursor, end, header->nbTrieVariants * sizeof(int));
+    aView->caseNodes = (const int *)readSection(cursor, end, header->nbTrieNodes > 0 ? header->nbCases * sizeof(int) : 0);
+    if (aView->nameOffsets == nullptr || aView->names == nullptr || aView->ids == nullptr || aView->offsets == nullptr
+        || aView->codes == nullptr || aView->timestamps == nullptr || aView->textEvents == nullptr
+        || aView->textOffsets == nullptr || aView->texts == nullptr || aView->trieNodes == nullptr
+        || aView->trieVariants == nullptr || aView->caseNodes == nullptr)
+        return false;
+    if (aView->offsets[0] != 0 || aView->offsets[header->nbCases] != header->nbEvents
+        || aView->nameOffsets[header->nbNames] > header->namesSize || aView->textOffsets[header->nbTexts] > header->textsSize)
+        return false;
+    for (uint64_t i = 0; i < header->nbCases; ++i)
+        if (aView->offsets[i] > aView->offsets[i + 1])
+            return false;
+    for (uint64_t i = 0; i < header->nbTexts; ++i)     //évènements strictement croissants : rattachés en un seul parcours
+        if (aView->textEvents[i] >= header->nbEvents || (i > 0 && aView->textEvents[i] <= aView->textEvents[i - 1])
+            || aView->textOffsets[i] > aView->textOffsets[i + 1])
+            return false;
+
+    for (uint64_t code = 0; code < header->nbNames; ++code)
+        if (aView->nameOffsets[code] > aView->nameOffsets[code + 1])
+            return false;
+    for (uint64_t i = 0; i < header->nbEvents; ++i)
+        if ((uint64_t)aView->codes[i] >= header->nbNames)
+            return false;
+    if (!checkSnapshotTrie(aView))
+        return false;
+
+    //noms ajoutés au dictionnaire seulement une fois le snapshot entièrement validé
+    aView->codeMap.resize(header->nbNames);
+    for (uint64_t code = 0; code < header->nbNames; ++code)
+        aView->codeMap[code] = internActivity(aView->names + aView->nameOffsets[code], aView->nameOffsets[code + 1] - aView->nameOffsets[code]);
+    return true;
+}
+
+/**
+ * @brief Recrée les processus du dernier au premier avec push_front pour retrouver l'ordre
+ * de la liste sauvegardée ; les activités sont chaînées directement, sans analyse de texte.
+ * Si la liste suit ses variants, l'arbre sauvegardé est recopié (codes traduits) avec le nœud de chaque cas :
+ * les variants restent dans l'ordre de l'extraction. Sans arbre dans le fichier, les cas sont suivis
+ * dans l'ordre de leur première apparition
+ */
+bool loadSnapshot(ProcessList * aList, string aFileName, string aSourceName)
+{
+    MappedFile file;
+    if (!mapFile(&file, aFileName))
+        return false;
+    SnapshotView view;
+    if (!openSnapshot(&file, aSourceName, &view))
+    {
+        unmapFile(&file);
+        return false;
+    }
+    uint64_t text = view.header->nbTexts;
+    VariantTrie * trie = aList->variantTrie;
+    bool isTrieCopied = trie != nullptr && view.header->nbTrieNodes > 0 && trie->nodes.size() == 1 && trie->variants.empty();
+    if (isTrieCopied)
+    {
+        trie->nodes.assign(view.trieNodes, view.trieNodes + view.header->nbTrieNodes);
+        for (size_t i = 1; i < trie->nodes.size(); ++i)
+            trie->nodes[i].code = view.codeMap[trie->nodes[i].code];
+        trie->variants.assign(view.trieVariants, view.trieVariants + view.header->nbTrieVariants);
+    }
+    for (uint64_t i = view.header->nbCases; i-- > 0; )
+    {
+        Process * aProcess = newProcess(aList);
+        aProcess->id = view.ids[i];
+        Activity * previous = nullptr;
+        for (uint64_t event = view.offsets[i]; event < view.offsets[i + 1]; ++event)
+        {
+            Activity * anActivity = newActivity(aList->arena);
+            anActivity->code = view.codeMap[view.codes[event]];
+            anActivity->timestamp = view.timestamps[event];
+            if (previous == nullptr)
+                aProcess->firstActivity = anActivity;
+            else
+                previous->nextActivity = anActivity;
+            previous = anActivity;
+        }
+        aProcess->lastActivity = previous;
+        aProcess->nbActivities = view.offsets[i + 1] - view.offsets[i];
+        if (isTrieCopied)
+            aProcess->trieNode = view.caseNodes[i];
+        else if (aProcess->trie != nullptr && aProcess->firstActivity != nullptr)
+            trieFollow(aProcess->trie, aProcess, aProcess->firstActivity);
+        push_front(aList, aProcess);
+    }
+    //les dates illisibles, dans l'ordre des évènements : rattachées après coup
+    if (text > 0)
+    {
+        uint64_t event = 0;
+        uint64_t textIndex = 0;
+        for (Process * processPtr = aList->firstProcess; processPtr != nullptr && textIndex < text; processPtr = processPtr->nextProcess)
+            for (Activity * activityPtr = processPtr->firstActivity; activityPtr != nullptr && textIndex < text; activityPtr = activityPtr->nextActivity, ++event)
+                if (view.textEvents[textIndex] == event)
+                {
+                    keepTimeText(aList->arena, activityPtr, view.texts + view.textOffsets[textIndex], view.textOffsets[textIndex + 1] - view.textOffsets[textIndex]);
+                    textIndex++;
+                }
+    }
+    unmapFile(&file);
+    return true;
+}
+
+/**
+ * @brief Les tableaux du fichier ont la disposition de l'EventStore : simples copies,
+ * seuls les codes sont traduits
+ */
+bool loadSnapshot(EventStore * aStore, string aFileName, string aSourceName)
+{
+    MappedFile file;
+    if (!mapFile(&file, aFileName))
+        return false;
+    SnapshotView view;
+    if (!openSnapshot(&file, aSourceName, &view))
+    {
+        unmapFile(&file);
+        return false;
+    }
+    const SnapshotHeader * header = view.header;
+    aStore->ids.assign(view.ids, view.ids + header->nbCases);
+    aStore->offsets.assign(view.offsets, view.offsets + header->nbCases + 1);
+    aStore->codes.resize(header->nbEvents);
+    for (uint64_t i = 0; i < header->nbEvents; ++i)
+        aStore->codes[i] = view.codeMap[view.codes[i]];
+    aStore->timestamps.assign(view.timestamps, view.timestamps + header->nbEvents);
+    unmapFile(&file);
+    return true;
+}
+
+
+/*
+ * Variant trie
+ */
+
+/**
+ * @brief Descend dans l'arbre activité par activité pour chaque cas en incrémentant nbCases
+ * de chaque nœud traversé, le dernier nœud du cas compte le cas dans frequency
+ */
+void buildTrie(ProcessList * aList, VariantTrie * aTrie)
+{
+    aTrie->nodes.assign(1, TrieNode());
+    aTrie->variants.clear();
+    for (Process * processPtr = aList->firstProcess; processPtr != nullptr; processPtr = processPtr->nextProcess)
+    {
+        int node = 0;
+        aTrie->nodes[0].nbCases++;
+        for (Activity * activityPtr = processPtr->firstActivity; activityPtr != nullptr; activityPtr = activityPtr->nextActivity)
+        {
+            node = trieChild(aTrie, node, activityCode(activityPtr));
+            aTrie->nodes[node].nbCases++;
+        }
+        trieEnd(aTrie, node, 1, processPtr->id);
+    }
+}
+
+int trieFind(const VariantTrie * aTrie, const int * aCodes, int aLength)
+{
+    if (aTrie->nodes.empty())
+        return -1;
+    int node = 0;
+    for (int i = 0; i < aLength && node != -1; ++i)
+    {
+        int child = aTrie->nodes[node].firstChild;
+        while (child != -1 && aTrie->nodes[child].code != aCodes[i])
+            child = aTrie->nodes[child].nextSibling;
+        node = child;
+    }
+    return node;
+}
+
+/**
+ * @brief Le nombre de cas est lu dans le nœud du préfixe, aucun cas n'est parcouru
+ */
+int casesWithPrefix(const VariantTrie * aTrie, Process * aPrefix)
+{
+    vector<int> codes;
+    for (Activity * activityPtr = aPrefix->firstActivity; activityPtr != nullptr; activityPtr = activityPtr->nextActivity)
+        codes.push_back(activityCode(activityPtr));
+    int node = trieFind(aTrie, codes.data(), codes.size());
+    return node == -1 ? 0 : aTrie->nodes[node].nbCases;
+}
+
+/**
+ * @brief Remonte de chaque nœud terminal jusqu'à la racine pour retrouver la séquence,
+ * les variants sont ajoutés avec push_front dans leur ordre d'apparition, comme variants().
+ * L'id d'un variant est lu dans aCaseIds (indexé par nœud) s'il est donné et connu, sinon dans le nœud
+ */
+static void copyTrieVariants(const VariantTrie * aTrie, ProcessList * aVariant, const vector<int> * aCaseIds)
+{
+    vector<int> codes;
+    for (size_t i = 0; i < aTrie->variants.size(); ++i)
+    {
+        const TrieNode * terminal = &aTrie->nodes[aTrie->variants[i]];
+        if (terminal->frequency == 0)   //arbre suivi : ses cas ont continué après ce nœud
+            continue;
+        codes.clear();
+        for (int node = aTrie->variants[i]; node > 0; node = aTrie->nodes[node].parent)
+            codes.push_back(aTrie->nodes[node].code);
+        Process * aProcess = newProcess(aVariant);
+        aProcess->id = terminal->firstCaseId;
+        if (aCaseIds != nullptr && (*aCaseIds)[aTrie->variants[i]] != UNKNOWN_CASE_ID)
+            aProcess->id = (*aCaseIds)[aTrie->variants[i]];
+        aProcess->frequency = terminal->frequency;
+        for (size_t j = codes.size(); j-- > 0; )
+        {
+            Activity * anActivity = newActivity(aVariant->arena);
+            anActivity->code = codes[j];
+            anActivity->timestamp = 0;
+            push_back(aProcess, anActivity);
+        }
+        push_front(aVariant, aProcess);
+    }
+}
+
+void trieVariants(const VariantTrie * aTrie, ProcessList * aVariant)
+{
+    copyTrieVariants(aTrie, aVariant, nullptr);
+}
+
+/**
+ * @brief Le représentant de chaque variant est le premier cas de la liste qui s'arrête sur son nœud
+ * (trieNode de chaque processus suivi), comme dans variants()
+ */
+void trieVariants(ProcessList * aList, ProcessList * aVariant)
+{
+    if (aList->variantTrie == nullptr)
+        return;
+    vector<int> caseIds(aList->variantTrie->nodes.size(), UNKNOWN_CASE_ID);
+    for (Process * processPtr = aList->firstProcess; processPtr != nullptr; processPtr = processPtr->nextProcess)
+    {
+        if (processPtr->trie == aList->variantTrie && processPtr->firstActivity != nullptr
+            && caseIds[processPtr->trieNode] == UNKNOWN_CASE_ID)
+            caseIds[processPtr->trieNode] = processPtr->id;
+    }
+    copyTrieVariants(aList->variantTrie, aVariant, &caseIds);
+}
+
+
+/*
+ * Parallel variants
+ */
+
+/**
+ * @brief Découpe la liste en nbThreads morceaux de cas consécutifs (un parcours des pointeurs) :
+ * le morceau i va de bounds[i] inclus à bounds[i + 1] exclu, nullptr étant la fin de la liste.
+ * S'il y a moins de cas que de threads les derniers morceaux sont vides
+ */
+static vector<Process *> caseShards(ProcessList * aProcessList, int nbThreads)
+{
+    vector<Process *> bounds(nbThreads + 1, nullptr);
+    bounds[0] = aProcessList->firstProcess;
+    int shardSize = aProcessList->size / nbThreads + 1;
+    int shard = 1;
+    int position = 0;
+    for (Process * processPtr = aProcessList->firstProcess; processPtr != nullptr && shard < nbThreads; processPtr = processPtr->nextProcess)
+    {
+        if (++position == shardSize * shard)
+            bounds[shard++] = processPtr->nextProcess;
+    }
+    return bounds;
+}
+
+/**
+ * @brief Variants trouvés par un thread sur son morceau, dans l'ordre d'apparition :
+ * premier cas du variant, empreinte et nombre de cas
+ */
+struct ShardVariants
+{
+    vector<Process *> firstCases;
+    vector<uint64_t> hashes;
+    vector<int> counts;
+};
+
+/**
+ * @brief Cherche les variants des cas de [aBegin, anEnd) dans une table locale au thread,
+ * un variant est représenté par son premier cas (aucune copie), firstCase est son rang d'apparition
+ */
+static void shardVariants(Process * aBegin, Process * anEnd, ShardVariants * aShard, atomic<size_t> * aProgress)
+{
+    vector<VariantSlot> table(16, VariantSlot{0, nullptr, 0});
+    size_t reported = 0;
+    size_t nbDone = 0;
+    for (Process * processPtr = aBegin; processPtr != anEnd; processPtr = processPtr->nextProcess)
+    {
+        uint64_t hash = 0;
+        for (Activity * activityPtr = processPtr->firstActivity; activityPtr != nullptr; activityPtr = activityPtr->nextActivity)
+            hash = hashStep(hash, activityCode(activityPtr));
+        VariantSlot * slot = findVariant(table, hash, [processPtr](VariantSlot * aSlot) {
+            return sameSequence(aSlot->variant, processPtr);
+        });
+        if (slot->variant != nullptr)
+            aShard->counts[slot->firstCase]++;
+        else
+        {
+            *slot = VariantSlot{hash, processPtr, (int)aShard->firstCases.size()};
+            aShard->firstCases.push_back(processPtr);
+            aShard->hashes.push_back(hash);
+            aShard->counts.push_back(1);
+            growVariantTable(table, aShard->firstCases.size());
+        }
+        if (++nbDone - reported >= 4096)
+        {
+            *aProgress += nbDone - reported;
+            reported = nbDone;
+        }
+    }
+    *aProgress += nbDone - reported;
+}
+
+/**
+ * @brief Découpe la liste en nbThreads morceaux de cas consécutifs (un parcours des pointeurs),
+ * chaque morceau est traité par shardVariants sur son propre thread pendant que
+ * le thread principal affiche la progression, puis les variants des morceaux sont
+ * fusionnés dans l'ordre des morceaux : un variant est copié la première fois qu'il est vu,
+ * ensuite seul son nombre de cas est ajouté. L'ordre d'apparition est donc celui de variants()
+ */
+void variantsParallel(ProcessList * aProcessList, ProcessList * aVariant, int nbThreads)
+{
+    if (nbThreads <= 0)
+        nbThreads = thread::hardware_concurrency();
+    if (nbThreads <= 0)
+        nbThreads = 1;
+    cout<<"Début de l'analyse des variants, "<<aProcessList->size<<" processus trouvés, "<<nbThreads<<" threads"<<endl;
+    vector<Process *> bounds = caseShards(aProcessList, nbThreads);
+
+    vector<ShardVariants> shards(nbThreads);
+    vector<thread> workers;
+    atomic<size_t> progress(0);
+    atomic<int> nbRunning(nbThreads);
+    for (int i = 0; i < nbThreads; ++i)
+    {
+        workers.emplace_back([&, i]() {
+            shardVariants(bounds[i], bounds[i + 1], &shards[i], &progress);
+            nbRunning--;
+        });
+    }
+    while (nbRunning > 0 && aProcessList->size != 0)
+    {
+        printProgressBar(progress * 99 / aProcessList->size, 100);
+        this_thread::sleep_for(chrono::milliseconds(100));
+    }
+    for (int i = 0; i < nbThreads; ++i)
+        workers[i].join();
+
+    vector<VariantSlot> table(16, VariantSlot{0, nullptr, 0});
+    size_t nbVariants = 0;
+    for (int i = 0; i < nbThreads; ++i)
+    {
+        ShardVariants * aShard = &shards[i];
+        for (size_t k = 0; k < aShard->firstCases.size(); ++k)
+        {
+            Process * firstCase = aShard->firstCases[k];
+            VariantSlot * slot = findVariant(table, aShard->hashes[k], [firstCase](VariantSlot * aSlot) {
+                return sameSequence(aSlot->variant, firstCase);
+            });
+            if (slot->variant != nullptr)
+                slot->variant->frequency += aShard->counts[k];
+            else
+            {
+                Process * aProcess = newProcess(aVariant);
+                aProcess->id = firstCase->id;
+                for (Activity * activityPtr = firstCase->firstActivity; activityPtr != nullptr; activityPtr = activityPtr->nextActivity)
+                {
+                    Activity * aCopy = newActivity(aVariant->arena);
+                    aCopy->code = activityCode(activityPtr);
+                    aCopy->timestamp = 0;
+                    push_back(aProcess, aCopy);
+                }
+                push_front(aVariant, aProcess);
+                aProcess->frequency = aShard->counts[k];
+                *slot = VariantSlot{aShard->hashes[k], aProcess, 0};
+                growVariantTable(table, ++nbVariants);
+            }
+        }
+    }
+    printProgressBar(100, 100);
+    cout<<aVariant->size<<" variants trouvés"<<endl;
+}
+
+
+/*
+ * Top variants
+ */
+
+/**
+ * @brief Ajoute un entier en varint : 7 bits par octet, le bit de poids fort indique qu'un octet suit
+ */
+static void appendVarint(vector<uint8_t> & aBuffer, uint64_t aValue)
+{
+    while (aValue >= 0x80)
+    {
+        aBuffer.push_back((uint8_t)(aValue | 0x80));
+        aValue >>= 7;
+    }
+    aBuffer.push_back((uint8_t)aValue);
+}
+
+/**
+ * @brief Regroupe les cas par variant en un parcours, dans l'ordre de la liste.
+ * Si tous les cas sont suivis par l'arbre de la liste, le nœud de chaque cas identifie son variant,
+ * sinon la séquence est cherchée dans une table de hachage comme dans variants().
+ * aVariantOf reçoit le variant de chaque cas, aFirstCases et aCounts le premier cas et le nombre de cas de chaque variant
+ */
+static void groupCases(ProcessList * aProcessList, vector<int> & aVariantOf, vector<Process *> & aFirstCases, vector<int> & aCounts)
+{
+    VariantTrie * trie = aProcessList->variantTrie;
+    for (Process * processPtr = aProcessList->firstProcess; processPtr != nullptr && trie != nullptr; processPtr = processPtr->nextProcess)
+        if (processPtr->trie != trie)
+            trie = nullptr;     //processus ajouté à la main : pas de nœud
+    vector<int> variantOfNode(trie != nullptr ? trie->nodes.size() : 0, -1);
+    vector<VariantSlot> table(trie != nullptr ? 0 : 16, VariantSlot{0, nullptr, 0});
+    for (Process * processPtr = aProcessList->firstProcess; processPtr != nullptr; processPtr = processPtr->nextProcess)
+    {
+        int variant = aFirstCases.size();
+        if (trie != nullptr)
+        {
+            if (variantOfNode[processPtr->trieNode] == -1)
+                variantOfNode[processPtr->trieNode] = variant;
+            variant = variantOfNode[processPtr->trieNode];
+        }
+        else
+        {
+            uint64_t hash = 0;
+            for (Activity * activityPtr = processPtr->firstActivity; activityPtr != nullptr; activityPtr = activityPtr->nextActivity)
+                hash = hashStep(hash, activityCode(activityPtr));
+            VariantSlot * slot = findVariant(table, hash, [processPtr](VariantSlot * aSlot) {
+                return sameSequence(aSlot->variant, processPtr);
+            });
+            if (slot->variant == nullptr)
+                *slot = VariantSlot{hash, processPtr, variant};
+            variant = slot->firstCase;
+        }
+        if (variant == (int)aFirstCases.size())  //nouveau variant
+        {
+            aFirstCases.push_back(processPtr);
+            aCounts.push_back(0);
+            if (trie == nullptr)
+                growVariantTable(table, aFirstCases.size());
+        }
+        aCounts[variant]++;
+        aVariantOf.push_back(variant);
+    }
+}
+
+/**
+ * @brief Compte les variants (groupCases), sélectionne les k plus fréquents par un tri partiel
+ * (partial_sort : O(variants log k) au lieu d'un tri complet), puis un second parcours des cas
+ * ne garde que les ids des cas des variants retenus, triés puis codés en varint (écarts entre ids)
+ */
+void topVariants(ProcessList * aProcessList, int k, ProcessList * aVariant, vector<TopVariant> * aTop)
+{
+    vector<int> variantOf;
+    vector<Process *> firstCases;
+    vector<int> counts;
+    groupCases(aProcessList, variantOf, firstCases, counts);
+    int nbSelected = k < (int)counts.size() ? max(k, 0) : counts.size();
+    vector<int> order(counts.size());
+    iota(order.begin(), order.end(), 0);
+    partial_sort(order.begin(), order.begin() + nbSelected, order.end(), [&counts](int aVariant, int anOther) {
+        return counts[aVariant] > counts[anOther] || (counts[aVariant] == counts[anOther] && aVariant < anOther);
+    });
+
+    vector<int> rankOf(counts.size(), -1);
+    for (int rank = 0; rank < nbSelected; ++rank)
+        rankOf[order[rank]] = rank;
+    vector<vector<int>> caseIds(nbSelected);
+    size_t caseIndex = 0;
+    for (Process * processPtr = aProcessList->firstProcess; processPtr != nullptr; processPtr = processPtr->nextProcess, ++caseIndex)
+        if (rankOf[variantOf[caseIndex]] != -1)
+            caseIds[rankOf[variantOf[caseIndex]]].push_back(processPtr->id);
+
+    aTop->assign(nbSelected, TopVariant());
+    for (int rank = nbSelected - 1; rank >= 0; --rank)  //push_front : le plus fréquent en tête
+    {
+        Process * firstCase = firstCases[order[rank]];
+        Process * aProcess = newProcess(aVariant);
+        aProcess->id = firstCase->id;
+        aProcess->frequency = counts[order[rank]];
+        for (Activity * activityPtr = firstCase->firstActivity; activityPtr != nullptr; activityPtr = activityPtr->nextActivity)
+        {
+            Activity * aCopy = newActivity(aVariant->arena);
+            aCopy->code = activityCode(activityPtr);
+            aCopy->timestamp = 0;
+            push_back(aProcess, aCopy);
+        }
+        push_front(aVariant, aProcess);
+
+        TopVariant * top = &(*aTop)[rank];
+        top->variant = aProcess;
+        top->coverage = 100.0 * aProcess->frequency / variantOf.size();
+        vector<int> & ids = caseIds[rank];
+        sort(ids.begin(), ids.end());
+        int64_t previous = 0;
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            if (i == 0)
+                appendVarint(top->caseIds, ((uint64_t)ids[0] << 1) ^ (uint64_t)(ids[0] >> 31));    //zigzag : un id négatif reste court
+            else
+                appendVarint(top->caseIds, (uint64_t)(ids[i] - previous));
+            previous = ids[i];
+        }
+    }
+}
+
+vector<int> topVariantCases(const TopVariant * aTopVariant)
+{
+    vector<int> ids;
+    uint64_t value = 0;
+    int shift = 0;
+    for (size_t i = 0; i < aTopVariant->caseIds.size(); ++i)
+    {
+        value |= (uint64_t)(aTopVariant->caseIds[i] & 0x7F) << shift;
+        shift += 7;
+        if (aTopVariant->caseIds[i] & 0x80)
+            continue;
+        if (ids.empty())
+            ids.push_back((int)((value >> 1) ^ (~(value & 1) + 1)));
+        else
+            ids.push_back((int)(ids.back() + (int64_t)value));
+        value = 0;
+        shift = 0;
+    }
+    return ids;
+}
+
+
+/*
+ * Activity histograms
+ */
+
+/**
+ * @brief Compte la première et la dernière activité des cas de [aBegin, anEnd).
+ * La dernière activité est lastActivity (sinon la liste est parcourue, processus construit à la main),
+ * un code plus grand que les histogrammes (dictionnaire complété entre temps) les agrandit
+ */
+static void countStartEnd(Process * aBegin, Process * anEnd, vector<int> & aStarts, vector<int> & anEnds)
+{
+    for (Process * processPtr = aBegin; processPtr != anEnd; processPtr = processPtr->nextProcess)
+    {
+        if (processPtr->firstActivity == nullptr)
+            continue;
+        Activity * last = processPtr->lastActivity;
+        if (last == nullptr)
+            for (last = processPtr->firstActivity; last->nextActivity != nullptr; last = last->nextActivity);
+        size_t start = activityCode(processPtr->firstActivity);
+        size_t end = activityCode(last);
+        if (max(start, end) >= aStarts.size())
+        {
+            aStarts.resize(max(start, end) + 1, 0);
+            anEnds.resize(max(start, end) + 1, 0);
+        }
+        aStarts[start]++;
+        anEnds[end]++;
+    }
+}
+
+/**
+ * @brief Histogrammes denses indexés par code : un seul parcours des processus
+ */
+void startEndHistograms(ProcessList * aList, vector<int> * aStarts, vector<int> * anEnds)
+{
+    aStarts->assign(nbActivityCodes(), 0);
+    anEnds->assign(nbActivityCodes(), 0);
+    countStartEnd(aList->firstProcess, nullptr, *aStarts, *anEnds);
+}
+
+/**
+ * @brief Chaque thread compte un morceau de cas consécutifs (caseShards) dans ses propres histogrammes,
+ * les histogrammes sont ensuite additionnés
+ */
+void startEndHistogramsParallel(ProcessList * aList, vector<int> * aStarts, vector<int> * anEnds, int nbThreads)
+{
+    if (nbThreads <= 0)
+        nbThreads = thread::hardware_concurrency();
+    if (nbThreads <= 0)
+        nbThreads = 1;
+    vector<Process *> bounds = caseShards(aList, nbThreads);
+    vector<vector<int>> starts(nbThreads, vector<int>(nbActivityCodes(), 0));
+    vector<vector<int>> ends(nbThreads, vector<int>(nbActivityCodes(), 0));
+    vector<thread> workers;
+    for (int i = 0; i < nbThreads; ++i)
+        workers.emplace_back([&, i]() {
+            countStartEnd(bounds[i], bounds[i + 1], starts[i], ends[i]);
+        });
+    for (int i = 0; i < nbThreads; ++i)
+        workers[i].join();
+    aStarts->assign(nbActivityCodes(), 0);
+    anEnds->assign(nbActivityCodes(), 0);
+    for (int i = 0; i < nbThreads; ++i)
+    {
+        if (starts[i].size() > aStarts->size())
+        {
+            aStarts->resize(starts[i].size(), 0);
+            anEnds->resize(starts[i].size(), 0);
+        }
+        for (size_t code = 0; code < starts[i].size(); ++code)
+        {
+            (*aStarts)[code] += starts[i][code];
+            (*anEnds)[code] += ends[i][code];
+        }
+    }
+}
+
+
+/*
+ * Directly-follows graph
+ */
+
+/**
+ * @brief Compte les transitions des cas [aFirstCase, aLastCase) dans une matrice propre au thread :
+ * les codes d'un cas sont contigus, la boucle lit le tableau de codes dans l'ordre
+ */
+static void countTransitions(const EventStore * aStore, int aFirstCase, int aLastCase, DirectlyFollowsGraph * aGraph)
+{
+    const int n = aGraph->nbActivities;
+    const int * codes = aStore->codes.data();
+    for (int i = aFirstCase; i < aLastCase; ++i)
+    {
+        size_t begin = aStore->offsets[i];
+        size_t end = aStore->offsets[i + 1];
+        if (begin == end)
+            continue;
+        aGraph->starts[codes[begin]]++;
+        aGraph->ends[codes[end - 1]]++;
+        for (size_t j = begin + 1; j < end; ++j)
+            aGraph->edges[(size_t)codes[j - 1] * n + codes[j]]++;
+    }
+}
+
+/**
+ * @brief Découpe les cas d'un store en morceaux d'environ autant d'évènements (recherche dans offsets) :
+ * le morceau i va du cas bounds[i] inclus au cas bounds[i + 1] exclu.
+ * Le nombre de threads (nbThreads, hardware_concurrency si <= 0) est borné par le nombre de cas
+ */
+static vector<int> eventShards(const EventStore * aStore, int & nbThreads)
+{
+    if (nbThreads <= 0)
+        nbThreads = thread::hardware_concurrency();
+    int nbCasesInStore = nbCases(aStore);
+    if (nbThreads > nbCasesInStore)
+        nbThreads = nbCasesInStore;
+    if (nbThreads <= 0)
+        nbThreads = 1;
+    size_t nbEvents = aStore->codes.size();
+    vector<int> bounds(nbThreads + 1, nbCasesInStore);
+    bounds[0] = 0;
+    for (int i = 1; i < nbThreads; ++i)
+        bounds[i] = upper_bound(aStore->offsets.begin(), aStore->offsets.end() - 1, nbEvents / nbThreads * i) - aStore->offsets.begin() - 1;
+    return bounds;
+}
+
+/**
+ * @brief Découpe les cas en morceaux d'environ autant d'évènements (eventShards, une matrice par thread :
+ * pas plus de threads que de cas), chaque thread remplit sa matrice avec countTransitions,
+ * puis les matrices sont additionnées
+ */
+void buildDfg(const EventStore * aStore, DirectlyFollowsGraph * aGraph, int nbThreads)
+{
+    int n = nbActivityCodes();
+    aGraph->nbActivities = n;
+    aGraph->edges.assign((size_t)n * n, 0);
+    aGraph->starts.assign(n, 0);
+    aGraph->ends.assign(n, 0);
+    vector<int> bounds = eventShards(aStore, nbThreads);
+
+    vector<DirectlyFollowsGraph> partials(nbThreads - 1);
+    vector<thread> workers;
+    for (int i = 1; i < nbThreads; ++i)
+    {
+        DirectlyFollowsGraph * partial = &partials[i - 1];
+        partial->nbActivities = n;
+        partial->edges.assign((size_t)n * n, 0);
+        partial->starts.assign(n, 0);
+        partial->ends.assign(n, 0);
+        workers.emplace_back([=]() {
+            countTransitions(aStore, bounds[i], bounds[i + 1], partial);
+        });
+    }
+    countTransitions(aStore, bounds[0], bounds[1], aGraph);  //premier morceau : directement dans le résultat
+    for (int i = 1; i < nbThreads; ++i)
+    {
+        workers[i - 1].join();
+        const DirectlyFollowsGraph * partial = &partials[i - 1];
+        for (size_t k = 0; k < aGraph->edges.size(); ++k)
+            aGraph->edges[k] += partial->edges[k];
+        for (int code = 0; code < n; ++code)
+        {
+            aGraph->starts[code] += partial->starts[code];
+            aGraph->ends[code] += partial->ends[code];
+        }
+    }
+}
+
+void buildDfg(ProcessList * aList, DirectlyFollowsGraph * aGraph, int nbThreads)
+{
+    EventStore store;
+    buildEventStore(aList, &store);
+    buildDfg(&store, aGraph, nbThreads);
+}
+
+int64_t dfgEdge(const DirectlyFollowsGraph * aGraph, int aFrom, int aTo)
+{
+    if (aFrom < 0 || aTo < 0 || aFrom >= aGraph->nbActivities || aTo >= aGraph->nbActivities)
+        return 0;
+    return aGraph->edges[(size_t)aFrom * aGraph->nbActivities + aTo];
+}
+
+
+/*
+ * Duration statistics
+ */
+
+/**
+ * @brief Capacité d'un niveau : k pour le plus haut, 2/3 de moins à chaque niveau en dessous (au moins 2)
+ */
+static size_t sketchCapacity(const QuantileSketch * aSketch, size_t aLevel)
+{
+    double capacity = aSketch->k;
+    for (size_t h = aLevel + 1; h < aSketch->levels.size(); ++h)
+        capacity *= 2.0 / 3.0;
+    return capacity < 2 ? 2 : (size_t)capacity;
+}
+
+/**
+ * @brief Compacte les niveaux pleins en partant du bas : le niveau est trié et une valeur sur deux
+ * (les paires ou les impaires, tiré par le générateur) monte au niveau suivant avec un poids double.
+ * Si le niveau a un nombre impair de valeurs la plus grande reste, le poids total est conservé
+ */
+static void sketchCompact(QuantileSketch * aSketch)
+{
+    for (size_t h = 0; h < aSketch->levels.size(); ++h)
+    {
+        if (aSketch->levels[h].size() < sketchCapacity(aSketch, h))
+            continue;
+        if (h + 1 == aSketch->levels.size())
+            aSketch->levels.emplace_back();
+        vector<double> & level = aSketch->levels[h];
+        sort(level.begin(), level.end());
+        size_t nbPaired = level.size() & ~(size_t)1;
+        aSketch->coin ^= aSketch->coin << 13;     //xorshift : reproductible d'une exécution à l'autre
+        aSketch->coin ^= aSketch->coin >> 17;
+        aSketch->coin ^= aSketch->coin << 5;
+        for (size_t i = aSketch->coin & 1; i < nbPaired; i += 2)
+            aSketch->levels[h + 1].push_back(level[i]);
+        level.erase(level.begin(), level.begin() + nbPaired);
+    }
+}
+
+void sketchAdd(QuantileSketch * aSketch, double aValue)
+{
+    if (aSketch->count == 0 || aValue < aSketch->min)
+        aSketch->min = aValue;
+    if (aSketch->count == 0 || aValue > aSketch->max)
+        aSketch->max = aValue;
+    aSketch->count++;
+    aSketch->sum += aValue;
+    if (aSketch->levels.empty())
+        aSketch->levels.emplace_back();
+    aSketch->levels[0].push_back(aValue);
+    if (aSketch->levels[0].size() >= sketchCapacity(aSketch, 0))
+        sketchCompact(aSketch);
+}
+
+/**
+ * @brief Les niveaux de même poids sont concaténés puis compactés
+ */
+void sketchMerge(QuantileSketch * aSketch, const QuantileSketch * anOther)
+{
+    if (anOther->count == 0)
+        return;
+    if (aSketch->count == 0 || anOther->min < aSketch->min)
+        aSketch->min = anOther->min;
+    if (aSketch->count == 0 || anOther->max > aSketch->max)
+        aSketch->max = anOther->max;
+    aSketch->count += anOther->count;
+    aSketch->sum += anOther->sum;
+    if (aSketch->levels.size() < anOther->levels.size())
+        aSketch->levels.resize(anOther->levels.size());
+    for (size_t h = 0; h < anOther->levels.size(); ++h)
+        aSketch->levels[h].insert(aSketch->levels[h].end(), anOther->levels[h].begin(), anOther->levels[h].end());
+    sketchCompact(aSketch);
+}
+
+/**
+ * @brief Les valeurs de tous les niveaux sont triées avec leur poids (2^niveau),
+ * on renvoie la première dont le poids cumulé atteint aQuantile * count
+ */
+double sketchQuantile(const QuantileSketch * aSketch, double aQuantile)
+{
+    if (aSketch->count == 0)
+        return 0;
+    if (aQuantile <= 0)
+        return aSketch->min;
+    if (aQuantile >= 1)
+        return aSketch->max;
+    vector<pair<double, int64_t>> weighted;
+    for (size_t h = 0; h < aSketch->levels.size(); ++h)
+        for (size_t i = 0; i < aSketch->levels[h].size(); ++i)
+            weighted.push_back(make_pair(aSketch->levels[h][i], (int64_t)1 << h));
+    sort(weighted.begin(), weighted.end());
+    double rank = aQuantile * aSketch->count;
+    int64_t cumulated = 0;
+    for (size_t i = 0; i < weighted.size(); ++i)
+    {
+        cumulated += weighted[i].second;
+        if (cumulated >= rank)
+            return weighted[i].first;
+    }
+    return aSketch->max;
+}
+
+double sketchMean(const QuantileSketch * aSketch)
+{
+    return aSketch->count == 0 ? 0 : aSketch->sum / aSketch->count;
+}
+
+/**
+ * @brief Durée de chaque cas (dernier moins premier timestamp connu) et attente entre deux activités
+ * consécutives datées des cas [aFirstCase, aLastCase), dans les sketchs du thread.
+ * Une activité non datée coupe la chaîne : l'attente qui l'entoure n'est comptée pour aucune transition
+ */
+static void measureDurations(const EventStore * aStore, int aFirstCase, int aLastCase, DurationStatistics * aStatistics)
+{
+    const size_t n = aStatistics->nbActivities;
+    for (int i = aFirstCase; i < aLastCase; ++i)
+    {
+        int64_t first = NO_TIMESTAMP;
+        int64_t last = NO_TIMESTAMP;
+        int64_t previous = NO_TIMESTAMP;
+        int previousCode = -1;
+        for (size_t j = aStore->offsets[i]; j < aStore->offsets[i + 1]; ++j)
+        {
+            int64_t timestamp = aStore->timestamps[j];
+            if (timestamp == NO_TIMESTAMP)
+            {
+                previous = NO_TIMESTAMP;    //la transition suivante ne suit pas directement une activité datée
+                continue;
+            }
+            if (first == NO_TIMESTAMP)
+                first = timestamp;
+            if (previous != NO_TIMESTAMP)
+            {
+                double wait = timestamp - previous;
+                sketchAdd(&aStatistics->waitingTimes, wait);
+                sketchAdd(&aStatistics->transitionWaits[previousCode * n + aStore->codes[j]], wait);
+            }
+            previous = timestamp;
+            last = timestamp;
+            previousCode = aStore->codes[j];
+        }
+        if (first != NO_TIMESTAMP)
+            sketchAdd(&aStatistics->caseDurations, last - first);
+    }
+}
+
+/**
+ * @brief Même découpage que buildDfg (eventShards), chaque thread remplit ses propres sketchs
+ * avec measureDurations, puis ils sont fusionnés (sketchMerge) dans l'ordre des morceaux
+ */
+void durationStatistics(const EventStore * aStore, DurationStatistics * aStatistics, int nbThreads)
+{
+    *aStatistics = DurationStatistics();
+    aStatistics->nbActivities = nbActivityCodes();
+    vector<int> bounds = eventShards(aStore, nbThreads);
+    vector<DurationStatistics> partials(nbThreads - 1);
+    vector<thread> workers;
+    for (int i = 1; i < nbThreads; ++i)
+    {
+        DurationStatistics * partial = &partials[i - 1];
+        partial->nbActivities = aStatistics->nbActivities;
+        workers.emplace_back([=]() {
+            measureDurations(aStore, bounds[i], bounds[i + 1], partial);
+        });
+    }
+    measureDurations(aStore, bounds[0], bounds[1], aStatistics);
+    for (int i = 1; i < nbThreads; ++i)
+    {
+        workers[i - 1].join();
+        DurationStatistics * partial = &partials[i - 1];
+        sketchMerge(&aStatistics->caseDurations, &partial->caseDurations);
+        sketchMerge(&aStatistics->waitingTimes, &partial->waitingTimes);
+        for (auto & transition : partial->transitionWaits)
+            sketchMerge(&aStatistics->transitionWaits[transition.first], &transition.second);
+    }
+}
+
+void durationStatistics(ProcessList * aList, DurationStatistics * aStatistics, int nbThreads)
+{
+    EventStore store;
+    buildEventStore(aList, &store);
+    durationStatistics(&store, aStatistics, nbThreads);
+}
+
+const QuantileSketch * transitionWaitingTimes(const DurationStatistics * aStatistics, int aFrom, int aTo)
+{
+    if (aFrom < 0 || aTo < 0 || aFrom >= aStatistics->nbActivities || aTo >= aStatistics->nbActivities)
+        return nullptr;
+    auto transition = aStatistics->transitionWaits.find((size_t)aFrom * aStatistics->nbActivities + aTo);
+    return transition == aStatistics->transitionWaits.end() ? nullptr : &transition->second;
+}
+
+/**
+ * @brief Affiche une ligne par sketch : moyenne, min, max puis les quantiles p50, p90, p99 (en secondes)
+ */
+void displayDurationStatistics(const DurationStatistics * aStatistics)
+{
+    const QuantileSketch * sketches[2] = {&aStatistics->caseDurations, &aStatistics->waitingTimes};
+    const string names[2] = {"Durée des processus", "Attente entre activités"};
+    for (int i = 0; i < 2; ++i)
+    {
+        cout<<names[i]<<" ("<<sketches[i]->count<<" mesures) : moyenne "<<sketchMean(sketches[i])<<"s, min "<<sketches[i]->min
+            <<"s, max "<<sketches[i]->max<<"s, p50 "<<sketchQuantile(sketches[i], 0.5)<<"s, p90 "<<sketchQuantile(sketches[i], 0.9)
+            <<"s, p99 "<<sketchQuantile(sketches[i], 0.99)<<'s'<<endl;
+    }
+}
+
+
+/*
+ * Live tail mode
+ */
+
+/**
+ * @brief Ajoute un évènement comme insertEvent en tenant à jour les histogrammes du suivi :
+ * un nouveau cas compte son activité de début, sinon la fin précédente du cas est décomptée
+ */
+static void followEvent(LogFollower * aFollower, ProcessList * aList, const EventToken * anEvent)
+{
+    Activity * anActivity = makeActivity(aList, anEvent);
+    size_t code = anActivity->code;
+    if (code >= aFollower->starts.size())
+    {
+        aFollower->starts.resize(code + 1, 0);
+        aFollower->ends.resize(code + 1, 0);
+    }
+    Process * ptr = processExists(aList, anEvent->id);
+    if (ptr == nullptr)
+    {
+        Process * aProcess = newProcess(aList);
+        aProcess->id = anEvent->id;
+        appendActivity(aProcess, anActivity);
+        push_front(aList, aProcess);
+        aFollower->starts[code]++;
+    }
+    else
+    {
+        Activity * last = ptr->lastActivity;
+        if (last == nullptr)
+            for (last = ptr->firstActivity; last != nullptr && last->nextActivity != nullptr; last = last->nextActivity);
+        if (last != nullptr)
+            aFollower->ends[activityCode(last)]--;
+        else
+            aFollower->starts[code]++;   //processus vide construit à la main
+        appendActivity(ptr, anActivity);
+    }
+    aFollower->ends[code]++;
+    aFollower->nbEvents++;
+}
+
+/**
+ * @brief Identité du fichier qui porte le nom : change quand le fichier est remplacé (rotation)
+ */
+static bool fileIdentity(const string & aFileName, uint64_t * aDevice, uint64_t * anInode)
+{
+#ifndef _WIN32
+    struct stat status;
+    if (stat(aFileName.c_str(), &status) != 0)
+        return false;
+    *aDevice = status.st_dev;
+    *anInode = status.st_ino;
+    return true;
+#else
+    (void)aFileName; (void)aDevice; (void)anInode;
+    return false;
+#endif
+}
+
+/**
+ * @brief Place la surveillance inotify sur le fichier qui porte actuellement le nom suivi
+ * (celle de l'ancien fichier est retirée)
+ */
+static void followWatch(LogFollower * aFollower)
+{
+#ifdef __linux__
+    if (aFollower->notifier < 0)
+        aFollower->notifier = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (aFollower->notifier < 0)
+        return;
+    if (aFollower->watch >= 0)
+        inotify_rm_watch(aFollower->notifier, aFollower->watch);
+    //système de fichiers sans inotify : watch vaut -1 et on passe à l'interrogation
+    aFollower->watch = inotify_add_watch(aFollower->notifier, aFollower->fileName.c_str(), IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+#else
+    (void)aFollower;
+#endif
+}
+
+bool followOpen(LogFollower * aFollower, ProcessList * aList, string aFileName)
+{
+    followClose(aFollower);
+    *aFollower = LogFollower();
+    aFollower->fileName = aFileName;
+    ifstream iFile(aFileName, ios::binary);
+    if (!iFile.is_open())
+        return false;
+    trackVariants(aList);
+    startEndHistograms(aList, &aFollower->starts, &aFollower->ends);
+    fileIdentity(aFileName, &aFollower->device, &aFollower->inode);
+    followWatch(aFollower);
+    return true;
+}
+
+/**
+ * @brief Lit les octets ajoutés par blocs de 1 Mo derrière la ligne incomplète du lot précédent,
+ * puis découpe les lignes complètes avec nextEvent (même boucle que extractProcessesStream).
+ * Un autre fichier sous le même nom (rotation) est lu depuis le début et surveillé à la place de l'ancien
+ */
+int followPoll(LogFollower * aFollower, ProcessList * aList)
+{
+    uint64_t device = aFollower->device;
+    uint64_t inode = aFollower->inode;
+    fileIdentity(aFollower->fileName, &device, &inode);     //fichier absent : identité inchangée
+    if (device != aFollower->device || inode != aFollower->inode)
+    {
+        cout<<"Fichier remplacé : lecture depuis le début"<<endl;
+        aFollower->device = device;
+        aFollower->inode = inode;
+        aFollower->offset = 0;
+        aFollower->pending.clear();
+        followWatch(aFollower);
+    }
+    else if (aFollower->notifier >= 0 && aFollower->watch < 0)     //fichier déplacé puis remis
+        followWatch(aFollower);
+    ifstream iFile(aFollower->fileName, ios::binary);
+    if (!iFile.is_open())
+        return -1;
+    iFile.seekg(0, ios::end);
+    streampos position = iFile.tellg();
+    size_t size = position > 0 ? (size_t)position : 0;
+    if (size < aFollower->offset)
+    {
+        cout<<"Fichier tronqué : lecture depuis le début"<<endl;
+        aFollower->offset = 0;
+        aFollower->pending.clear();
+    }
+    iFile.seekg(aFollower->offset);
+    int64_t nbEventsBefore = aFollower->nbEvents;
+    EventToken event;
+    string & buffer = aFollower->pending;
+    while (aFollower->offset < size)
+    {
+        size_t pending = buffer.size();
+        size_t nbToRead = min(size - aFollower->offset, (size_t)1 << 20);
+        buffer.resize(pending + nbToRead);
+        iFile.read(&buffer[pending], nbToRead);
+        size_t nbRead = iFile.gcount();
+        buffer.resize(pending + nbRead);
+        aFollower->offset += nbRead;
+        if (nbRead == 0)
+            break;
+        const char * begin = buffer.data();
+        const char * end = begin + buffer.size();
+        while (end != begin && *(end - 1) != '\n')   //on s'arrête après la dernière ligne complète
+            end--;
+        const char * cursor = begin;
+        while (cursor != end)
+        {
+            const char * lineStart = cursor;
+            if (nextEvent(cursor, end, &event))
+                followEvent(aFollower, aList, &event);
+            else if (!isBlank(lineStart, cursor))
+                aFollower->nbInvalid++;
+        }
+        buffer.erase(0, end - begin);
+    }
+    return aFollower->nbEvents - nbEventsBefore;
+}
+
+/**
+ * @brief Avec inotify on attend un évènement sur le descripteur (poll) et on vide la file d'évènements,
+ * sinon on compare la taille et l'identité du fichier à celles lues toutes les 100 ms.
+ * Un fichier déplacé ou supprimé (rotation) n'est plus surveillé : on interroge jusqu'à ce que
+ * followPoll trouve le nouveau fichier et le surveille
+ */
+bool followWait(LogFollower * aFollower, int aTimeoutMs)
+{
+#ifdef __linux__
+    if (aFollower->notifier >= 0 && aFollower->watch >= 0)
+    {
+        pollfd descriptor = {aFollower->notifier, POLLIN, 0};
+        if (poll(&descriptor, 1, aTimeoutMs) <= 0)
+            return false;
+        alignas(inotify_event) char events[4096];
+        bool isMoved = false;
+        ssize_t nbRead;
+        while ((nbRead = read(aFollower->notifier, events, sizeof(events))) > 0)
+        {
+            for (ssize_t i = 0; i < nbRead; i += sizeof(inotify_event) + ((inotify_event *)(events + i))->len)
+                isMoved = isMoved || (((inotify_event *)(events + i))->mask & (IN_MOVE_SELF | IN_DELETE_SELF)) != 0;
+        }
+        if (isMoved)
+        {
+            inotify_rm_watch(aFollower->notifier, aFollower->watch);
+            aFollower->watch = -1;
+        }
+        return true;
+    }
+#endif
+    chrono::time_point<std::chrono::high_resolution_clock> startTime = getTime();
+    while (true)
+    {
+        error_code error;
+        uintmax_t size = filesystem::file_size(aFollower->fileName, error);
+        uint64_t device = aFollower->device;
+        uint64_t inode = aFollower->inode;
+        fileIdentity(aFollower->fileName, &device, &inode);
+        if (!error && (size != aFollower->offset || device != aFollower->device || inode != aFollower->inode))
+            return true;
+        if (calculateDuration(startTime, getTime()) * 1000 >= aTimeoutMs)
+            return false;
+        this_thread::sleep_for(chrono::milliseconds(min(aTimeoutMs, 100)));
+    }
+}
+
+void followClose(LogFollower * aFollower)
+{
+#ifdef __linux__
+    if (aFollower->notifier >= 0)
+        close(aFollower->notifier);
+#endif
+    aFollower->notifier = -1;
+    aFollower->watch = -1;
+}
+
+/**
+ * @brief Premier lot avec tout le contenu actuel du fichier, puis un lot à chaque modification
+ */
+void followLog(ProcessList * aList, string aFileName, function<bool(ProcessList *, const LogFollower *)> aBatchCallback, int aTimeoutMs)
+{
+    LogFollower follower;
+    if (!followOpen(&follower, aList, aFileName))
+    {
+        cout<<"Erreur d'ouverture du fichier"<<endl;
+        return;
+    }
+    bool isFollowing = true;
+    while (isFollowing)
+    {
+        if (followPoll(&follower, aList) < 0)
+            cout<<"Erreur de lecture du fichier"<<endl;
+        isFollowing = aBatchCallback(aList, &follower);
+        if (isFollowing)
+            followWait(&follower, aTimeoutMs);
+    }
+    followClose(&follower);
+}
+
+
+/*
+ * Memory-bounded streaming
+ */
+
+void streamOpen(CaseStream * aStream, vector<string> anEndActivities, int64_t aTimeout)
+{
+    streamClose(aStream);
+    *aStream = CaseStream();
+    aStream->timeout = aTimeout;
+    for (size_t i = 0; i < anEndActivities.size(); ++i)
+    {
+        size_t code = internActivity(anEndActivities[i]);
+        if (code >= aStream->isEndActivity.size())
+            aStream->isEndActivity.resize(code + 1, false);
+        aStream->isEndActivity[code] = true;
+    }
+    aStream->variants.nodes.assign(1, TrieNode());
+    aStream->dfg.nbActivities = 0;
+}
+
+/**
+ * @brief Agrandit la matrice du graphe quand le dictionnaire a reçu de nouvelles activités
+ * (les lignes sont recopiées avec la nouvelle largeur)
+ */
+static void growDfg(DirectlyFollowsGraph * aGraph, int nbActivities)
+{
+    if (nbActivities <= aGraph->nbActivities)
+        return;
+    vector<int64_t> edges((size_t)nbActivities * nbActivities, 0);
+    for (int from = 0; from < aGraph->nbActivities; ++from)
+        copy(aGraph->edges.begin() + (size_t)from * aGraph->nbActivities, aGraph->edges.begin() + (size_t)(from + 1) * aGraph->nbActivities,
+             edges.begin() + (size_t)from * nbActivities);
+    aGraph->edges.swap(edges);
+    aGraph->starts.resize(nbActivities, 0);
+    aGraph->ends.resize(nbActivities, 0);
+    aGraph->nbActivities = nbActivities;
+}
+
+/**
+ * @brief Ajoute le cas aux agrégats (chemin dans l'arbre des variants, transitions, longueur)
+ * puis libère ses activités et le retire des cas ouverts
+ */
+static void finishCase(CaseStream * aStream, unordered_map<int, StreamCase>::iterator aCase)
+{
+    Process * aProcess = aCase->second.process;
+    growDfg(&aStream->dfg, nbActivityCodes());
+    DirectlyFollowsGraph * graph = &aStream->dfg;
+    VariantTrie * trie = &aStream->variants;
+    int node = 0;
+    trie->nodes[0].nbCases++;
+    int previous = -1;
+    for (Activity * activityPtr = aProcess->firstActivity; activityPtr != nullptr; activityPtr = activityPtr->nextActivity)
+    {
+        int code = activityCode(activityPtr);
+        node = trieChild(trie, node, code);
+        trie->nodes[node].nbCases++;
+        if (previous == -1)
+            graph->starts[code]++;
+        else
+            graph->edges[(size_t)previous * graph->nbActivities + code]++;
+        previous = code;
+    }
+    graph->ends[previous]++;
+    trieEnd(trie, node, 1, aProcess->id);
+    sketchAdd(&aStream->caseLengths, aProcess->nbActivities);
+    aStream->nbFinished++;
+    clear(aProcess);
+    delete aProcess;
+    aStream->openCases.erase(aCase);
+}
+
+/**
+ * @brief Tas des échéances : la plus proche en tête
+ */
+static bool isLaterExpiry(const CaseExpiry & anExpiry, const CaseExpiry & anOther)
+{
+    return anExpiry.time > anOther.time;
+}
+
+static void scheduleCase(CaseStream * aStream, int aProcessId, StreamCase * aCase)
+{
+    CaseExpiry expiry;
+    expiry.time = aCase->lastSeen;
+    expiry.id = aProcessId;
+    expiry.serial = aCase->serial;
+    aStream->expiries.push_back(expiry);
+    push_heap(aStream->expiries.begin(), aStream->expiries.end(), isLaterExpiry);
+    aCase->isScheduled = true;
+}
+
+/**
+ * @brief Dépile les échéances dépassées. Une entrée dont le cas est terminé (id absent ou rouvert
+ * par un autre cas) est jetée, un cas vu depuis est replacé à sa dernière activité, sinon il a expiré.
+ * Chaque cas ouvert a au plus une entrée : le tas ne grandit pas avec le nombre d'évènements
+ */
+static void expireCases(CaseStream * aStream)
+{
+    while (!aStream->expiries.empty() && aStream->expiries.front().time + aStream->timeout < aStream->clock)
+    {
+        CaseExpiry expiry = aStream->expiries.front();
+        pop_heap(aStream->expiries.begin(), aStream->expiries.end(), isLaterExpiry);
+        aStream->expiries.pop_back();
+        auto openCase = aStream->openCases.find(expiry.id);
+        if (openCase == aStream->openCases.end() || openCase->second.serial != expiry.serial)
+            continue;
+        if (openCase->second.lastSeen + aStream->timeout < aStream->clock)
+        {
+            aStream->nbTimedOut++;
+            finishCase(aStream, openCase);
+        }
+        else
+            scheduleCase(aStream, expiry.id, &openCase->second);
+    }
+}
+
+/**
+ * @brief Avance l'horloge du log et termine les cas inactifs avant d'ajouter l'évènement :
+ * un cas dont la dernière activité a expiré repart de zéro avec le même id.
+ * Un évènement sans timestamp compte pour l'heure courante du log
+ */
+void streamEvent(CaseStream * aStream, int aProcessId, Activity * anActivity)
+{
+    aStream->nbEvents++;
+    int64_t timestamp = anActivity->timestamp;
+    if (timestamp != NO_TIMESTAMP && (aStream->clock == NO_TIMESTAMP || timestamp > aStream->clock))
+    {
+        aStream->clock = timestamp;
+        if (aStream->timeout > 0)
+            expireCases(aStream);
+    }
+    auto openCase = aStream->openCases.find(aProcessId);
+    if (openCase == aStream->openCases.end())
+    {
+        StreamCase aCase;
+        aCase.process = new Process;
+        aCase.process->id = aProcessId;
+        aCase.serial = aStream->nbOpened++;
+        openCase = aStream->openCases.emplace(aProcessId, aCase).first;
+        aStream->maxOpenCases = max(aStream->maxOpenCases, (int)aStream->openCases.size());
+    }
+    push_back(openCase->second.process, anActivity);
+    if (aStream->clock != NO_TIMESTAMP)
+        openCase->second.lastSeen = aStream->clock;
+    size_t code = anActivity->code;
+    if (code < aStream->isEndActivity.size() && aStream->isEndActivity[code])
+    {
+        aStream->nbEnded++;
+        finishCase(aStream, openCase);
+    }
+    else if (aStream->timeout > 0 && !openCase->second.isScheduled && openCase->second.lastSeen != NO_TIMESTAMP)
+        scheduleCase(aStream, aProcessId, &openCase->second);
+}
+
+void streamEvent(CaseStream * aStream, int aProcessId, string anActivityName, string aTime)
+{
+    Activity * anActivity = new Activity;
+    anActivity->code = internActivity(anActivityName);
+    if (!parseTimestamp(aTime.data(), aTime.size(), &anActivity->timestamp))
+        anActivity->time = aTime;
+    streamEvent(aStream, aProcessId, anActivity);
+}
+
+void streamFlush(CaseStream * aStream)
+{
+    while (!aStream->openCases.empty())
+        finishCase(aStream, aStream->openCases.begin());
+    aStream->expiries.clear();
+}
+
+/**
+ * @brief Même parcours que extractProcessesMapped, les activités sont allouées avec new
+ * pour pouvoir être libérées cas par cas
+ */
+void streamFile(CaseStream * aStream, string aFileName)
+{
+    MappedFile file;
+    if (!mapFile(&file, aFileName))
+    {
+        cout<<"Erreur d'ouverture du fichier"<<endl;
+        return;
+    }
+    ProcessList heapList;   //sans arène : makeActivity alloue avec new
+    const char * cursor = file.data;
+    const char * end = file.data + file.size;
+    int nbInvalid = 0;
+    EventToken event;
+    while (cursor != end)
+    {
+        const char * lineStart = cursor;
+        if (nextEvent(cursor, end, &event))
+            streamEvent(aStream, event.id, makeActivity(&heapList, &event));
+        else if (!isBlank(lineStart, cursor))
+            nbInvalid++;
+    }
+    unmapFile(&file);
+    streamFlush(aStream);
+    if (nbInvalid != 0)
+        cout<<"Erreur de lecture du fichier : "<<nbInvalid<<" lignes invalides"<<endl;
+}
+
+void streamClose(CaseStream * aStream)
+{
+    for (auto & openCase : aStream->openCases)
+    {
+        clear(openCase.second.process);
+        delete openCase.second.process;
+    }
+    aStream->openCases.clear();
+    aStream->expiries.clear();
+}
+
+
+/*
+ * Multi-file ingestion
+ */
+
+/**
+ * @brief Ordre naturel : les suites de chiffres sont comparées par valeur (sans les zéros en tête),
+ * le reste caractère par caractère
+ */
+static bool naturalLess(const string & aName, const string & anOther)
+{
+    size_t i = 0;
+    size_t j = 0;
+    while (i < aName.size() && j < anOther.size())
+    {
+        if (isdigit((unsigned char)aName[i]) && isdigit((unsigned char)anOther[j]))
+        {
+            size_t endI = i;
+            size_t endJ = j;
+            while (endI < aName.size() && isdigit((unsigned char)aName[endI]))
+                endI++;
+            while (endJ < anOther.size() && isdigit((unsigned char)anOther[endJ]))
+                endJ++;
+            while (i + 1 < endI && aName[i] == '0')
+                i++;
+            while (j + 1 < endJ && anOther[j] == '0')
+                j++;
+            if (endI - i != endJ - j)
+                return endI - i < endJ - j;
+            int order = aName.compare(i, endI - i, anOther, j, endJ - j);
+            if (order != 0)
+                return order < 0;
+            i = endI;
+            j = endJ;
+        }
+        else
+        {
+            if (aName[i] != anOther[j])
+                return aName[i] < anOther[j];
+            i++;
+            j++;
+        }
+    }
+    return aName.size() - i < anOther.size() - j;
+}
+
+/**
+ * @brief Les dates de modification sont lues une fois avant le tri ; à date égale (copie, système de
+ * fichiers à la seconde) l'ordre naturel départage
+ */
+vector<string> logSegments(string aDirectory, SegmentOrder anOrder)
+{
+    vector<pair<filesystem::file_time_type, string>> names;
+    error_code error;
+    for (const filesystem::directory_entry & entry : filesystem::directory_iterator(aDirectory, error))
+    {
+        string name = entry.path().filename().string();
+        if (entry.is_regular_file() && !name.empty() && name[0] != '.')
+            names.push_back({entry.last_write_time(error), name});
+    }
+    sort(names.begin(), names.end(), [anOrder](const pair<filesystem::file_time_type, string> & aName, const pair<filesystem::file_time_type, string> & anOther) {
+        if (anOrder == SEGMENTS_BY_TIME && aName.first != anOther.first)
+            return aName.first < anOther.first;
+        if (anOrder == SEGMENTS_ROTATED)
+            return naturalLess(anOther.second, aName.second);
+        return naturalLess(aName.second, anOther.second);
+    });
+    vector<string> segments;
+    for (size_t i = 0; i < names.size(); ++i)
+        segments.push_back((filesystem::path(aDirectory) / names[i].second).string());
+    return segments;
+}
+
+/**
+ * @brief Les threads prennent le segment suivant (compteur atomique) : projection, parseRange dans
+ * la liste partielle du segment, libération de la projection. Le thread principal fusionne les listes
+ * dans l'ordre des segments dès qu'elles sont prêtes (mergeProcessLists) et affiche la progression
+ */
+void extractProcesses(ProcessList * aList, vector<string> aFileNames, int nbThreads)
+{
+    int nbSegments = aFileNames.size();
+    if (nbThreads <= 0)
+        nbThreads = thread::hardware_concurrency();
+    if (nbThreads > nbSegments)
+        nbThreads = nbSegments;
+    if (nbThreads <= 0)
+        nbThreads = 1;
+    size_t totalSize = 0;
+    for (int i = 0; i < nbSegments; ++i)
+    {
+        error_code error;
+        uintmax_t size = filesystem::file_size(aFileNames[i], error);
+        if (!error)
+            totalSize += size;
+    }
+    cout<<"Début de l'analyse de "<<nbSegments<<" fichiers, "<<totalSize<<" octets, "<<nbThreads<<" threads"<<endl;
+
+    vector<ProcessList *> partials(nbSegments);
+    vector<int> nbErrors(nbSegments, 0);
+    vector<bool> isReady(nbSegments, false);
+    vector<bool> isOpen(nbSegments, true);
+    mutex readyMutex;
+    condition_variable readyChanged;
+    atomic<int> nextSegment(0);
+    atomic<size_t> progress(0);
+    for (int i = 0; i < nbSegments; ++i)
+    {
+        partials[i] = new ProcessList;
+        if (aList->arena != nullptr)
+            enableArena(partials[i]);
+        if (aList->variantTrie != nullptr)
+            trackVariants(partials[i]);
+    }
+    vector<thread> workers;
+    for (int t = 0; t < nbThreads; ++t)
+        workers.emplace_back([&]() {
+            for (int i = nextSegment++; i < nbSegments; i = nextSegment++)
+            {
+                MappedFile file;
+                bool isMapped = mapFile(&file, aFileNames[i]);
+                if (isMapped)
+                {
+                    parseRange(file.data, file.data + file.size, partials[i], &progress, &nbErrors[i]);
+                    unmapFile(&file);
+                }
+                lock_guard<mutex> lock(readyMutex);
+                isOpen[i] = isMapped;
+                isReady[i] = true;
+                readyChanged.notify_one();
+            }
+        });
+
+    int nbUnopened = 0;
+    for (int i = 0; i < nbSegments; ++i)
+    {
+        {
+            unique_lock<mutex> lock(readyMutex);
+            while (!readyChanged.wait_for(lock, chrono::milliseconds(100), [&]() { return isReady[i]; }))
+                if (totalSize != 0)
+                    printProgressBar(min((size_t)progress, totalSize) * 99 / totalSize, 100);
+            nbUnopened += !isOpen[i];
+        }
+        mergeProcessLists(aList, partials[i]);  //les segments suivants continuent d'être analysés
+        clear(partials[i]);
+    }
+    for (int t = 0; t < nbThreads; ++t)
+        workers[t].join();
+    printProgressBar(100, 100);
+    int nbInvalid = accumulate(nbErrors.begin(), nbErrors.end(), 0);
+    if (nbUnopened != 0)
+        cout<<"Erreur d'ouverture de "<<nbUnopened<<" fichiers"<<endl;
+    if (nbInvalid != 0)
+        cout<<"Erreur de lecture du fichier : "<<nbInvalid<<" lignes invalides"<<endl;
+}
+
+
+/*
+ * Compressed ingestion
+ */
+
+/**
+ * @brief Seul un fichier régulier est ouvert : lire les deux octets d'un tube ou de /dev/stdin les retirerait
+ * du flux avant que le vrai lecteur ne l'ouvre
+ */
+bool isGzipFile(string aFileName)
+{
+    error_code error;
+    if (!filesystem::is_regular_file(aFileName, error))
+        return false;
+    ifstream iFile(aFileName, ios::binary);
+    unsigned char magic[2] = {0, 0};
+    iFile.read((char *)magic, 2);
+    return iFile.gcount() == 2 && magic[0] == 0x1f && magic[1] == 0x8b;
+}
+
+/**
+ * @brief Attend un emplacement libre (le consommateur n'a pas encore rendu tous les blocs), renvoie son index
+ */
+static size_t waitFreeBlock(BlockQueue * aQueue)
+{
+    unique_lock<mutex> lock(aQueue->guard);
+    aQueue->changed.wait(lock, [&]() { return aQueue->nbFilled < aQueue->blocks.size(); });
+    return (aQueue->first + aQueue->nbFilled) % aQueue->blocks.size();
+}
+
+/**
+ * @brief Le producteur publie l'emplacement rempli (ou ferme la file si aClose)
+ */
+static void publishBlock(BlockQueue * aQueue, size_t aSize, bool aClose)
+{
+    lock_guard<mutex> lock(aQueue->guard);
+    if (aClose)
+        aQueue->isClosed = true;
+    else
+    {
+        aQueue->sizes[(aQueue->first + aQueue->nbFilled) % aQueue->blocks.size()] = aSize;
+        aQueue->nbFilled++;
+    }
+    aQueue->changed.notify_all();
+}
+
+/**
+ * @brief Attend le plus ancien bloc rempli, renvoie son index ou -1 si la file est fermée et vide
+ */
+static int waitFilledBlock(BlockQueue * aQueue)
+{
+    unique_lock<mutex> lock(aQueue->guard);
+    aQueue->changed.wait(lock, [&]() { return aQueue->nbFilled > 0 || aQueue->isClosed; });
+    return aQueue->nbFilled > 0 ? (int)aQueue->first : -1;
+}
+
+/**
+ * @brief Le consommateur rend le plus ancien bloc au producteur
+ */
+static void releaseBlock(BlockQueue * aQueue)
+{
+    lock_guard<mutex> lock(aQueue->guard);
+    aQueue->first = (aQueue->first + 1) % aQueue->blocks.size();
+    aQueue->nbFilled--;
+    aQueue->changed.notify_all();
+}
+
+/**
+ * @brief Thread de décompression : remplit les blocs libres avec gzread jusqu'à la fin du fichier
+ * (gzread enchaîne les membres d'un fichier concaténé), aProgress suit les octets compressés lus.
+ * Un fichier tronqué s'arrête sur un bloc vide avec l'erreur Z_BUF_ERROR (gzerror)
+ */
+static void inflateBlocks(gzFile aFile, BlockQueue * aQueue, atomic<size_t> * aProgress, bool * anError)
+{
+    while (true)
+    {
+        size_t slot = waitFreeBlock(aQueue);
+        int nbRead = gzread(aFile, aQueue->blocks[slot].data(), aQueue->blocks[slot].size());
+        *aProgress = gzoffset(aFile);
+        if (nbRead <= 0)
+        {
+            int errorCode = Z_OK;
+            gzerror(aFile, &errorCode);
+            *anError = nbRead < 0 || errorCode != Z_OK;
+            publishBlock(aQueue, 0, true);
+            return;
+        }
+        publishBlock(aQueue, nbRead, false);
+    }
+}
+
+/**
+ * @brief Analyse les lignes complètes de [aBegin, anEnd) avec nextEvent et insertEvent
+ */
+static void parseLines(ProcessList * aList, const char * aBegin, const char * anEnd, int * aNbInvalid)
+{
+    EventToken event;
+    const char * cursor = aBegin;
+    while (cursor != anEnd)
+    {
+        const char * lineStart = cursor;
+        if (nextEvent(cursor, anEnd, &event))
+            insertEvent(aList, event.id, makeActivity(aList, &event));
+        else if (!isBlank(lineStart, cursor))
+            (*aNbInvalid)++;
+    }
+}
+
+/**
+ * @brief 8 blocs de 1 Mo entre le thread de décompression (inflateBlocks) et le thread appelant.
+ * Les lignes complètes d'un bloc sont analysées sur place, seule la ligne à cheval sur deux blocs
+ * est recopiée (fin du bloc précédent + début du suivant) avant d'être analysée
+ */
+void extractProcessesGzip(ProcessList * aList, string aFileName)
+{
+    gzFile file = gzopen(aFileName.c_str(), "rb");
+    if (file == nullptr)
+    {
+        cout<<"Erreur d'ouverture du fichier"<<endl;
+        return;
+    }
+    gzbuffer(file, 256 << 10);
+    error_code error;
+    uintmax_t fileSize = filesystem::file_size(aFileName, error);
+    if (error)
+        fileSize = 0;
+    cout<<"Début de l'analyse du fichier compressé, "<<fileSize<<" octets"<<endl;
+    BlockQueue queue;
+    queue.blocks.assign(8, vector<char>(1 << 20));
+    queue.sizes.assign(8, 0);
+    atomic<size_t> progress(0);
+    bool isCorrupted = false;
+    thread inflater(inflateBlocks, file, &queue, &progress, &isCorrupted);
+
+    string pending;     //ligne incomplète à la fin du bloc précédent
+    int nbInvalid = 0;
+    size_t nextStep = fileSize / 100 + 1;
+    for (int slot = waitFilledBlock(&queue); slot != -1; slot = waitFilledBlock(&queue))
+    {
+        const char * begin = queue.blocks[slot].data();
+        const char * end = begin + queue.sizes[slot];
+        const char * firstLineEnd = find(begin, end, '\n');
+        if (!pending.empty())
+        {
+            if (firstLineEnd == end)    //ligne plus longue qu'un bloc
+            {
+                pending.append(begin, end);
+                releaseBlock(&queue);
+                continue;
+            }
+            pending.append(begin, firstLineEnd + 1);
+            parseLines(aList, pending.data(), pending.data() + pending.size(), &nbInvalid);
+            pending.clear();
+            begin = firstLineEnd + 1;
+        }
+        const char * lastLineEnd = end;
+        while (lastLineEnd != begin && *(lastLineEnd - 1) != '\n')
+            lastLineEnd--;
+        parseLines(aList, begin, lastLineEnd, &nbInvalid);
+        pending.assign(lastLineEnd, end);
+        releaseBlock(&queue);
+        if (fileSize != 0 && progress >= nextStep)
+        {
+            printProgressBar(min((size_t)progress, (size_t)fileSize) * 99 / fileSize, 100);
+            nextStep = progress + fileSize / 100 + 1;
+        }
+    }
+    parseLines(aList, pending.data(), pending.data() + pending.size(), &nbInvalid);  //dernière ligne sans '\n'
+    inflater.join();
+    gzclose(file);
+    printProgressBar(100, 100);
+    if (isCorrupted)
+        cout<<"Erreur de décompression du fichier"<<endl;
+    if (nbInvalid != 0)
+        cout<<"Erreur de lecture du fichier : "<<nbInvalid<<" lignes invalides"<<endl;
+}
+
+
+/*
+ * Pipelined ingestion
+ */
+
+/**
+ * @brief Anneau de aCapacity places (arrondi à une puissance de 2)
+ */
+static void ringInit(SpscRing * aRing, size_t aCapacity)
+{
+    size_t capacity = 1;
+    while (capacity < aCapacity)
+        capacity *= 2;
+    aRing->slots.assign(capacity, 0);
+    aRing->head = 0;
+    aRing->tail = 0;
+    aRing->isClosed = false;
+}
+
+/**
+ * @brief Attend que aReady soit vrai : quelques essais avec yield, puis sommeil sur la variable de condition.
+ * nbSleeping est publié avant de revérifier aReady, l'autre côté le lit après avoir publié son changement
+ * (barrières seq_cst des deux côtés) : un réveil ne peut pas être perdu
+ */
+template <typename Predicate>
+static void ringWait(SpscRing * aRing, Predicate aReady)
+{
+    for (int i = 0; i < 64; ++i)
+    {
+        if (aReady())
+            return;
+        this_thread::yield();
+    }
+    unique_lock<mutex> lock(aRing->guard);
+    aRing->nbSleeping.fetch_add(1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    aRing->changed.wait(lock, aReady);
+    aRing->nbSleeping.fetch_sub(1, memory_order_relaxed);
+}
+
+/**
+ * @brief Réveille le thread endormi sur l'anneau, s'il y en a un
+ */
+static void ringWake(SpscRing * aRing)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if (aRing->nbSleeping.load(memory_order_relaxed) != 0)
+    {
+        lock_guard<mutex> lock(aRing->guard);
+        aRing->changed.notify_all();
+    }
+}
+
+/**
+ * @brief Producteur : attend une place libre (ringWait), écrit la valeur puis la publie (release sur tail)
+ */
+static void ringPush(SpscRing * aRing, int aValue)
+{
+    size_t tail = aRing->tail.load(memory_order_relaxed);
+    ringWait(aRing, [aRing, tail]() { return tail - aRing->head.load(memory_order_acquire) != aRing->slots.size(); });
+    aRing->slots[tail & (aRing->slots.size() - 1)] = aValue;
+    aRing->tail.store(tail + 1, memory_order_release);
+    ringWake(aRing);
+}
+
+/**
+ * @brief Consommateur : attend une valeur ou la fermeture (ringWait), lit la valeur puis libère sa place (release sur head).
+ * Renvoie false quand l'anneau est fermé et vide
+ */
+static bool ringPop(SpscRing * aRing, int * aValue)
+{
+    size_t head = aRing->head.load(memory_order_relaxed);
+    ringWait(aRing, [aRing, head]() { return head != aRing->tail.load(memory_order_acquire) || aRing->isClosed.load(memory_order_acquire); });
+    if (head == aRing->tail.load(memory_order_acquire))    //fermé : tail est publié avant isClosed
+        return false;
+    *aValue = aRing->slots[head & (aRing->slots.size() - 1)];
+    aRing->head.store(head + 1, memory_order_release);
+    ringWake(aRing);
+    return true;
+}
+
+/**
+ * @brief Ferme l'anneau et réveille le consommateur
+ */
+static void ringClose(SpscRing * aRing)
+{
+    aRing->isClosed.store(true, memory_order_release);
+    ringWake(aRing);
+}
+
+/**
+ * @brief Découpe les lignes complètes de [aBegin, anEnd) dans le lot (nextEvent, internActivity, parseTimestamp)
+ */
+static void parseBatch(const char * aBegin, const char * anEnd, EventBatch * aBatch)
+{
+    EventToken token;
+    const char * cursor = aBegin;
+    while (cursor != anEnd)
+    {
+        const char * lineStart = cursor;
+        if (nextEvent(cursor, anEnd, &token))
+        {
+            ParsedEvent event;
+            event.id = token.id;
+            event.code = internActivity(token.name, token.nameLength);
+            if (!parseTimestamp(token.time, token.timeLength, &event.timestamp))
+            {
+                event.text = aBatch->texts.size();
+                aBatch->texts.emplace_back(token.time, token.timeLength);
+            }
+            aBatch->events.push_back(event);
+        }
+        else if (!isBlank(lineStart, cursor))
+            aBatch->nbInvalid++;
+    }
+}
+
+/**
+ * @brief Les trois étages et leurs anneaux : chaque lien a un anneau des tampons remplis (vers l'aval)
+ * et un anneau des tampons libres (vers l'amont), les tampons sont alloués une seule fois
+ */
+void extractProcessesPipeline(ProcessList * aList, string aFileName)
+{
+    ifstream iFile(aFileName, ios::binary);
+    if (!iFile.is_open())
+    {
+        cout<<"Erreur d'ouverture du fichier"<<endl;
+        return;
+    }
+    const int nbBuffers = 8;
+    vector<vector<char>> blocks(nbBuffers, vector<char>(1 << 20));
+    vector<size_t> blockSizes(nbBuffers, 0);
+    vector<EventBatch> batches(nbBuffers);
+    SpscRing filledBlocks, freeBlocks, filledBatches, freeBatches;
+    ringInit(&filledBlocks, nbBuffers);
+    ringInit(&freeBlocks, nbBuffers);
+    ringInit(&filledBatches, nbBuffers);
+    ringInit(&freeBatches, nbBuffers);
+    for (int i = 0; i < nbBuffers; ++i)
+    {
+        ringPush(&freeBlocks, i);
+        ringPush(&freeBatches, i);
+    }
+
+    thread reader([&]() {   //étage 1 : lectures brutes
+        int block;
+        while (ringPop(&freeBlocks, &block))
+        {
+            iFile.read(blocks[block].data(), blocks[block].size());
+            blockSizes[block] = iFile.gcount();
+            if (blockSizes[block] == 0)
+                break;
+            ringPush(&filledBlocks, block);
+        }
+        ringClose(&filledBlocks);
+    });
+    thread parser([&]() {   //étage 2 : découpage et analyse, la ligne à cheval sur deux blocs est recopiée
+        string pending;
+        int block;
+        int batch = -1;
+        while (ringPop(&filledBlocks, &block))
+        {
+            ringPop(&freeBatches, &batch);
+            batches[batch].events.clear();
+            batches[batch].texts.clear();
+            batches[batch].nbInvalid = 0;
+            const char * begin = blocks[block].data();
+            const char * end = begin + blockSizes[block];
+            if (!pending.empty())
+            {
+                const char * firstLineEnd = find(begin, end, '\n');
+                pending.append(begin, firstLineEnd == end ? end : firstLineEnd + 1);
+                begin = firstLineEnd == end ? end : firstLineEnd + 1;
+                if (firstLineEnd != end)
+                {
+                    parseBatch(pending.data(), pending.data() + pending.size(), &batches[batch]);
+                    pending.clear();
+                }
+            }
+            const char * lastLineEnd = end;
+            while (lastLineEnd != begin && *(lastLineEnd - 1) != '\n')
+                lastLineEnd--;
+            parseBatch(begin, lastLineEnd, &batches[batch]);
+            pending.append(lastLineEnd, end);
+            ringPush(&freeBlocks, block);
+            ringPush(&filledBatches, batch);
+        }
+        if (!pending.empty())   //dernière ligne sans '\n'
+        {
+            ringPop(&freeBatches, &batch);
+            batches[batch].events.clear();
+            batches[batch].texts.clear();
+            batches[batch].nbInvalid = 0;
+            parseBatch(pending.data(), pending.data() + pending.size(), &batches[batch]);
+            ringPush(&filledBatches, batch);
+        }
+        ringClose(&filledBatches);
+    });
+
+    int nbInvalid = 0;      //étage 3 : insertion dans la liste sur le thread appelant
+    int batch;
+    while (ringPop(&filledBatches, &batch))
+    {
+        const EventBatch & events = batches[batch];
+        for (size_t i = 0; i < events.events.size(); ++i)
+        {
+            const ParsedEvent & event = events.events[i];
+            Activity * anActivity = newActivity(aList->arena);
+            anActivity->code = event.code;
+            anActivity->timestamp = event.timestamp;
+            if (event.text != -1)
+                keepTimeText(aList->arena, anActivity, events.texts[event.text].data(), events.texts[event.text].size());
+            insertEvent(aList, event.id, anActivity);
+        }
+        nbInvalid += events.nbInvalid;
+        ringPush(&freeBatches, batch);
+    }
+    reader.join();
+    parser.join();
+    if (nbInvalid != 0)
+        cout<<"Erreur de lecture du fichier : "<<nbInvalid<<" lignes invalides"<<endl;
+}
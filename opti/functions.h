@@ -11,6 +11,8 @@
 #include "typeDef.h"
 #include <iostream>
 #include <chrono>
+#include <cstddef>
+#include <functional>
 
 using namespace std;
 
@@ -39,6 +41,7 @@ double calculateDuration(chrono::time_point<std::chrono::high_resolution_clock>
 
 /**
  * @brief Count the number of lines of a file
+ * A last line without a final newline is counted
  * @param: string, the file name
  * @return an int corresponding to the number of lines
  */
@@ -61,24 +64,53 @@ void clearConsole();
 void printProgressBar(int nb, int max);
 
 
+/*
+ * Arena allocation
+ */
+
+/**
+ * @brief Allocate the processes, activities and summaries of a list in an arena owned by the list
+ * Must be called on an empty list. Allocation becomes a pointer bump and clear(ProcessList *)
+ * releases the whole list at once
+ * @param: ProcessList *, a process list
+ */
+void enableArena(ProcessList * aList);
+
+/**
+ * @brief Move the blocks of an arena into another one (the source arena is left empty)
+ * @param: Arena *, the arena receiving the blocks
+ * @param: Arena *, the arena giving its blocks
+ */
+void adoptArena(Arena * anArena, Arena * anOther);
+
+/**
+ * @brief Free every block of an arena (destroying the activities owning a string first)
+ * @param: Arena *, the arena to release, reusable afterwards
+ */
+void releaseArena(Arena * anArena);
+
+
 /*
  * Utility functions for data structure
  */
 
 /**
  * @brief Delete a process. Free the memory occupied by each Activity * then the Process *
+ * (activities allocated in an arena are only unlinked, the arena frees them)
  * @param: Process *, a list to delete
  */
 void clear(Process * aList);
 
 /**
  * @brief Delete a process list. Free the memory occupied by each element Process * then the ProcessList *
+ * A list using an arena is freed at once by releasing the arena
  * @param: ProcessList *, a process list to delete
  */
 void clear(ProcessList * aList);
 
 /**
  * @brief Display a list of activities of a process
+ * The names are resolved from the activity dictionary
  * @param: a Process*
  */
 void displayActivitiesList(Process * aProcess);
@@ -91,6 +123,7 @@ void displayProcessesList(ProcessList * aList);
 
 /**
  * @brief Add an activity at the end of an activity list
+ * O(1) when the last activity of the process is known
  * @param: a Process*
  * @param: an Activity*
  */
@@ -98,6 +131,7 @@ void push_back(Process * aProcess, Activity* anActivity);
 
 /**
  * @brief Add an activity to a process
+ * The name is interned and the time parsed (see Activity)
  * @param: Process*, a process
  * @param: string, an activity name
  * @param: string a timestamp
@@ -131,6 +165,7 @@ void insertProcessActivity(ProcessList * aList, int aProcessId, string anActivit
 
 /**
  * @brief Determine if a process id is already in the process list
+ * O(1) lookup in the hash index of the list (rebuilt first if the list was modified by hand)
  * @param: ProcessList *, a process list
  * @param: int, the process id
  * @return a Process * if the id already exists, nullptr otherwise
@@ -138,6 +173,85 @@ void insertProcessActivity(ProcessList * aList, int aProcessId, string anActivit
 Process * processExists(ProcessList * aList, int aProcessId);
 
 
+/*
+ * Activity dictionary
+ * Every distinct activity name is interned once in a global dictionary
+ * and identified by a dense code (0, 1, 2... in order of first appearance)
+ */
+
+/**
+ * @brief Get the code of an activity name, adding the name to the dictionary if needed
+ * Can be called from several threads
+ * @param: string, an activity name
+ * @return the code of the name
+ */
+int internActivity(string anActivityName);
+
+/**
+ * @brief Get the code of an activity name given by its characters, without building a string
+ * (a string is only allocated when the name is added to the dictionary)
+ * Can be called from several threads
+ * @param: const char *, the first character of the name
+ * @param: size_t, the length of the name
+ * @return the code of the name
+ */
+int internActivity(const char * aName, size_t aLength);
+
+/**
+ * @brief Get the name corresponding to a code of the dictionary
+ * @param: int, an activity code
+ * @return the activity name, an empty string for an unknown code
+ */
+string activityName(int aCode);
+
+/**
+ * @brief Get the number of names in the activity dictionary
+ * @return the number of codes (the codes are 0 to nbActivityCodes() - 1)
+ */
+int nbActivityCodes();
+
+/**
+ * @brief Get the code of an activity, interning its name if it has no code yet
+ * (activities built by hand only have a name)
+ * @param: Activity *, an activity
+ * @return the code of the activity
+ */
+int activityCode(Activity * anActivity);
+
+/**
+ * @brief Get the name of an activity, resolved from the dictionary if the activity only has a code
+ * @param: Activity *, an activity
+ * @return the activity name
+ */
+string getActivityName(Activity * anActivity);
+
+
+/*
+ * Timestamps
+ */
+
+/**
+ * @brief Parse a timestamp without any allocation. Accepted formats:
+ * - ctime with dashes: Fri-Feb--3-19:44:59-2023 (spaces are accepted instead of dashes)
+ * - ISO-8601: 2023-02-03, 2023-02-03T19:44:59, with optional fraction (ignored) and Z or +hh:mm offset
+ * - an integer number of seconds since the epoch: 1675453499
+ * Times without offset are considered UTC
+ * @param: const char *, the text
+ * @param: size_t, the length of the text
+ * @param: int64_t *, the parsed time in seconds since the epoch (unchanged if the text can't be parsed)
+ * @return true if the text was parsed
+ */
+bool parseTimestamp(const char * aText, size_t aLength, int64_t * aTimestamp);
+
+/**
+ * @brief Get the timestamp of an activity, parsing its text if it has none yet
+ * (activities built by hand only have a text)
+ * @param: Activity *, an activity
+ * @return the timestamp, NO_TIMESTAMP if the text can't be parsed
+ */
+int64_t getActivityTimestamp(Activity * anActivity);
+
+
 /*
  * Processes Functions
  */
@@ -152,13 +266,14 @@ double averageProcessLength(ProcessList * aList);
 /**
  * @brief Determine the set of end activities of process list
  * @param: ProcessList *, the process list
- * @param: Process *, the list of start activities
+ * @param: Process *, the list of end activities (copies sorted by name, no duplicates)
  */
 void endActivities(ProcessList * processList, Process * activityList);
 
 /**
  * @brief Extract all the processes from a file and store them
  * in a given process list
+ * A directory is read as a set of log segments, oldest first (see logSegments), a gzip file is decompressed on the fly
  * @param: ProcessList *, the process list,
  * @param: string, the file name
  */
@@ -167,13 +282,14 @@ void extractProcesses(ProcessList* aList, string fileName);
 /**
  * @brief Determine the set of start activities of process list
  * @param: ProcessList *, the process list
- * @param: Process *, the list of start activities
+ * @param: Process *, the list of start activities (copies sorted by name, no duplicates)
  */
 void startActivities(ProcessList * processList, Process * activityList);
 
 /**
  * @brief Extract the variant of a process list
  * A variant is a unique variation of a business process
+ * Each variant keeps the id of its first case and counts its cases in frequency
  * @param: ProcessList *, a process list
  * @param: ProcessList *, the resulting list of variants
  */
@@ -181,6 +297,7 @@ void variants(ProcessList * aProcessList, ProcessList * aVariant);
 
 /**
  * @brief Insert a sorted, unduplicated activity in a process
+ * Duplicates are detected on the activity codes, the order is the one of the names
  * @param: Process *, the process
  * @param : Activity *, the activity
  */
@@ -188,6 +305,7 @@ void insertActivity(Process * aProcess, Activity* anActivity);
 
 /**
  * @brief Determine if a process already exists in a process list
+ * The activities are compared on their codes
  * @param: ProcessList *, a process list
  * @param: Process *, the process
  * @return true if the process is found
@@ -218,8 +336,9 @@ void pushSummaryFront(ProcessList * aList, Process * aProcess);
 SummaryCell * summarySame(ProcessList * aList, int aProcessId);
 
 /**
- * Cherche si le processus existe déjà dans la liste donné comme processExists mais voyage par Sommaire(Summary).
+ * Cherche si le processus existe déjà dans la liste donné comme processExists.
  * Renvoie le pointeur du processus ou nullptr s'il n'existe pas
+ * (délègue à processExists et à l'index de hachage, les sommaires ne servent plus à la recherche)
  */
 Process * processSummaryExists(ProcessList * aList,  int aProcessId);
 
@@ -244,4 +363,665 @@ void addProcessSummary(ProcessList * aList, int aProcessId, string anActivityNam
 void displaySummary(ProcessList * aList);
 
 
+/*
+ * Columnar event store
+ */
+
+/**
+ * @brief Build the columnar copy of a process list (cases in list order, events in process order)
+ * @param: ProcessList *, the process list
+ * @param: EventStore *, the store to fill (previous content is replaced)
+ */
+void buildEventStore(ProcessList * aList, EventStore * aStore);
+
+/**
+ * @brief Get the number of cases of a store
+ * @param: const EventStore *, the store
+ * @return the number of cases
+ */
+int nbCases(const EventStore * aStore);
+
+/**
+ * @brief Get the number of events of a case
+ * @param: const EventStore *, the store
+ * @param: int, the case index (0 to nbCases - 1)
+ * @return the number of events of the case
+ */
+int caseLength(const EventStore * aStore, int aCase);
+
+/**
+ * @brief Get the activity codes of a case
+ * @param: const EventStore *, the store
+ * @param: int, the case index
+ * @return a pointer on the first code, caseLength codes are contiguous
+ */
+const int * caseActivities(const EventStore * aStore, int aCase);
+
+/**
+ * @brief Get the timestamps of a case
+ * @param: const EventStore *, the store
+ * @param: int, the case index
+ * @return a pointer on the first timestamp, caseLength timestamps are contiguous
+ */
+const int64_t * caseTimestamps(const EventStore * aStore, int aCase);
+
+/**
+ * @brief Calculate the average number of activities in the cases of a store
+ * @param: const EventStore *, the store
+ */
+double averageProcessLength(const EventStore * aStore);
+
+/**
+ * @brief Determine the set of start activities of a store
+ * @param: const EventStore *, the store
+ * @param: Process *, the list of start activities (sorted by name, no duplicates)
+ */
+void startActivities(const EventStore * aStore, Process * anActivityList);
+
+/**
+ * @brief Determine the set of end activities of a store
+ * @param: const EventStore *, the store
+ * @param: Process *, the list of end activities (sorted by name, no duplicates)
+ */
+void endActivities(const EventStore * aStore, Process * anActivityList);
+
+/**
+ * @brief Extract the variants of a store
+ * Each variant is added with push_front, with the id of its first case, its number of cases
+ * in frequency and timestamps at 0
+ * @param: const EventStore *, the store
+ * @param: ProcessList *, the resulting list of variants
+ */
+void variants(const EventStore * aStore, ProcessList * aVariant);
+
+
+/*
+ * Memory-mapped ingestion
+ */
+
+/**
+ * @brief Map a whole file in memory (read only)
+ * On Windows the file is loaded in a heap buffer instead
+ * @param: MappedFile *, the mapping to fill
+ * @param: string, the file name
+ * @return true if the file is mapped, false otherwise
+ */
+bool mapFile(MappedFile * aFile, string aFileName);
+
+/**
+ * @brief Release a file mapped by mapFile
+ * @param: MappedFile *, the mapping to release
+ */
+void unmapFile(MappedFile * aFile);
+
+/**
+ * @brief Tokenize the next line "id activity timestamp" of a buffer
+ * The tokens point inside the buffer, nothing is copied.
+ * The cursor is moved to the beginning of the next line.
+ * @param: const char *&, the cursor in the buffer
+ * @param: const char *, the end of the buffer
+ * @param: EventToken *, the tokens of the line
+ * @return true if a well formed line was read, false on a malformed line or at the end of the buffer
+ */
+bool nextEvent(const char *& aCursor, const char * anEnd, EventToken * anEvent);
+
+/**
+ * @brief Build an activity from the tokens of a line, allocated in the arena of the list if it has one
+ * The name is interned, the time is parsed by parseTimestamp (kept as text only if it can't be parsed)
+ * @param: ProcessList *, the list the activity will be added to
+ * @param: const EventToken *, the tokens of a line
+ * @return the new activity
+ */
+Activity * makeActivity(ProcessList * aList, const EventToken * anEvent);
+
+/**
+ * @brief Add an event to a process list, creating the process if its id is unknown
+ * (same bookkeeping as extractProcesses: processExists, then addProcess or addActivity)
+ * @param: ProcessList *, a process list
+ * @param: int, a process id
+ * @param: string, the activity name
+ * @param: string, the timestamp
+ */
+void insertEvent(ProcessList * aList, int aProcessId, string anActivityName, string aTime);
+
+/**
+ * @brief Add an already built activity to a process list, creating the process if its id is unknown
+ * @param: ProcessList *, a process list
+ * @param: int, a process id
+ * @param: Activity *, the activity (owned by the list afterwards)
+ */
+void insertEvent(ProcessList * aList, int aProcessId, Activity * anActivity);
+
+/**
+ * @brief Extract all the processes from a file in a single pass over a memory mapping
+ * Produces the same process list as extractProcesses without the nbOfLines pre-pass
+ * and without iostream parsing
+ * @param: ProcessList *, the process list,
+ * @param: string, the file name
+ */
+void extractProcessesMapped(ProcessList * aList, string aFileName);
+
+
+/*
+ * Parallel ingestion
+ */
+
+/**
+ * @brief Append the processes of a partial list to a process list
+ * The partial list must have been built with addProcess (processes in reverse order of
+ * first appearance). A process whose id is already known has its activities appended
+ * to the existing process, in order; a new process is moved into the list as
+ * extractProcesses would have created it. The partial list is left empty,
+ * its arena (if any) is moved to the process list.
+ * @param: ProcessList *, the process list
+ * @param: ProcessList *, the partial list to merge
+ */
+void mergeProcessLists(ProcessList * aList, ProcessList * aPartial);
+
+/**
+ * @brief Extract all the processes from a file using several threads
+ * The mapped file is split in byte ranges aligned on line boundaries, each range is
+ * parsed on its own thread into a partial list, then the partial lists are merged
+ * in file order. The result is the same process list as extractProcesses.
+ * @param: ProcessList *, the process list,
+ * @param: string, the file name
+ * @param: int, the number of threads (hardware concurrency if <= 0)
+ */
+void extractProcessesParallel(ProcessList * aList, string aFileName, int nbThreads);
+
+
+/*
+ * Streaming ingestion
+ */
+
+/**
+ * @brief Extract all the processes from a stream in a single pass, until the end of the stream
+ * The stream is read by blocks, no line count is needed: the progress is estimated
+ * from the bytes consumed against the size of the input, when it is known
+ * @param: ProcessList *, the process list,
+ * @param: istream &, the input stream (a file, cin...)
+ * @param: size_t, the size of the input in bytes, 0 if unknown (pipe, stdin)
+ */
+void extractProcessesStream(ProcessList * aList, istream & anInput, size_t anInputSize);
+
+/**
+ * @brief Extract all the processes from a file in a single pass, without the nbOfLines pre-pass
+ * extractProcesses is kept for the line counted behavior. A gzip file is given to extractProcessesGzip
+ * @param: ProcessList *, the process list,
+ * @param: string, the file name, "-" for the standard input
+ */
+void extractProcessesStream(ProcessList * aList, string aFileName);
+
+
+/*
+ * Vectorized scanning
+ * The scanners use AVX2 or SSE2 when the processor supports them (checked at run time)
+ * and a scalar loop otherwise
+ */
+
+/**
+ * @brief Get the scanner level in use
+ * @return 2 for AVX2, 1 for SSE2, 0 for scalar
+ */
+int scannerLevel();
+
+/**
+ * @brief Force the scanner level (for tests and benchmarks)
+ * @param: int, the wanted level (2 AVX2, 1 SSE2, 0 scalar), bounded by the processor capabilities
+ * @return the level actually in use
+ */
+int setScannerLevel(int aLevel);
+
+/**
+ * @brief Count the '\n' of a buffer
+ * @param: const char *, the buffer
+ * @param: size_t, the number of bytes
+ * @return the number of '\n'
+ */
+size_t countNewlines(const char * aData, size_t aSize);
+
+/**
+ * @brief Find the first field separator (space, tab, '\r' or '\n') of a buffer
+ * @param: const char *, the beginning of the buffer
+ * @param: const char *, the end of the buffer
+ * @return a pointer on the separator, or the end of the buffer if there is none
+ */
+const char * findSeparator(const char * aBegin, const char * anEnd);
+
+/**
+ * @brief Parse a decimal process id (optional sign then digits)
+ * @param: const char *&, the cursor, moved after the last digit
+ * @param: const char *, the end of the buffer
+ * @param: int *, the parsed id
+ * @return true if at least one digit was read
+ */
+bool parseId(const char *& aCursor, const char * anEnd, int * anId);
+
+
+/*
+ * Binary snapshots
+ * A snapshot saves an extracted process list (cases, activity dictionary and events)
+ * so that it can be reloaded by mmap instead of parsing the log again
+ */
+
+/**
+ * @brief Save a process list in a snapshot file
+ * @param: ProcessList *, the process list to save (the summary is not saved, the tracked variant trie is)
+ * @param: string, the snapshot file name
+ * @param: string, the log the list was extracted from, "" to skip the freshness check at load time
+ * @return true if the snapshot was written (false if the log can't be stat'ed)
+ */
+bool saveSnapshot(ProcessList * aList, string aFileName, string aSourceName = "");
+
+/**
+ * @brief Load a snapshot in an empty process list, identical to the list that was saved
+ * Activity codes are translated to the dictionary of the running program. If the list tracks its variants,
+ * the trie saved with the snapshot is restored, so the variants keep the order of the original extraction
+ * @param: ProcessList *, an empty process list
+ * @param: string, the snapshot file name
+ * @param: string, the log the snapshot must have been saved from, "" to accept any snapshot
+ * @return false if the file is missing, invalid, older than the log or if the log can't be stat'ed (the list is left empty)
+ */
+bool loadSnapshot(ProcessList * aList, string aFileName, string aSourceName = "");
+
+/**
+ * @brief Load a snapshot directly in a columnar event store (the arrays are copied as they are)
+ * @param: EventStore *, the store to fill
+ * @param: string, the snapshot file name
+ * @param: string, the log the snapshot must have been saved from, "" to accept any snapshot
+ * @return false if the file is missing, invalid, older than the log or if the log can't be stat'ed
+ */
+bool loadSnapshot(EventStore * aStore, string aFileName, string aSourceName = "");
+
+
+/*
+ * Variant trie
+ * The variants are stored as the paths of a prefix trie: shared prefixes are stored once
+ */
+
+/**
+ * @brief Build the trie of the activity sequences of a process list, in one pass
+ * @param: ProcessList *, a process list
+ * @param: VariantTrie *, the trie to fill (its previous content is removed)
+ */
+void buildTrie(ProcessList * aList, VariantTrie * aTrie);
+
+/**
+ * @brief Find the node of a sequence of activity codes
+ * @param: const VariantTrie *, the trie
+ * @param: const int *, the activity codes
+ * @param: int, the number of codes
+ * @return the index of the node, -1 if no case starts with this sequence
+ */
+int trieFind(const VariantTrie * aTrie, const int * aCodes, int aLength);
+
+/**
+ * @brief Count the cases starting with a sequence of activities, without scanning the cases
+ * @param: const VariantTrie *, the trie
+ * @param: Process *, the prefix (a list of activities, possibly empty)
+ * @return the number of cases starting with the prefix
+ */
+int casesWithPrefix(const VariantTrie * aTrie, Process * aPrefix);
+
+/**
+ * @brief Copy the variants of a trie in a process list, in the same order as variants()
+ * for a trie made by buildTrie, in order of first appearance for a tracked trie
+ * @param: const VariantTrie *, the trie
+ * @param: ProcessList *, the resulting list of variants (with frequency and timestamps at 0)
+ */
+void trieVariants(const VariantTrie * aTrie, ProcessList * aVariant);
+
+/**
+ * @brief Copy the variants of the tracked trie of a list in a process list
+ * The id of each variant is the one of its first case in the list, as in variants()
+ * (the ids kept in a tracked trie can be UNKNOWN_CASE_ID once their case has grown)
+ * @param: ProcessList *, the process list, tracking its variants (see trackVariants)
+ * @param: ProcessList *, the resulting list of variants (with frequency and timestamps at 0)
+ */
+void trieVariants(ProcessList * aList, ProcessList * aVariant);
+
+/**
+ * @brief Keep the variant trie of a list up to date while it is filled
+ * Each process remembers the trie node of its activity sequence (a fingerprint of the sequence):
+ * adding an activity moves the process to a child node, so the variants and their
+ * frequencies are known as soon as the extraction ends, without reading the list again.
+ * Must be called on an empty list; processes built by hand and linked with push_front aren't tracked
+ * @param: ProcessList *, a process list
+ */
+void trackVariants(ProcessList * aList);
+
+
+/*
+ * Parallel variants
+ */
+
+/**
+ * @brief Extract the variants of a process list using several threads
+ * The cases are split in consecutive shards, each thread finds the variants of its shard
+ * in a local table, then the tables are merged in shard order. The result is the same
+ * variant list (order, ids and frequencies) as variants()
+ * @param: ProcessList *, a process list
+ * @param: ProcessList *, the resulting list of variants
+ * @param: int, the number of threads (hardware concurrency if <= 0)
+ */
+void variantsParallel(ProcessList * aProcessList, ProcessList * aVariant, int nbThreads);
+
+
+/*
+ * Top variants
+ */
+
+/**
+ * @brief Find the k most frequent variants of a process list, with their coverage and their cases
+ * The variants are counted in one pass (with the trie of the list if it tracks variants)
+ * then the k most frequent are selected by a partial sort. Ties keep the order of variants()
+ * @param: ProcessList *, a process list
+ * @param: int, k the number of variants wanted
+ * @param: ProcessList *, the list receiving the top variants, most frequent first
+ * @param: vector<TopVariant> *, the top variants, most frequent first, with their cases
+ */
+void topVariants(ProcessList * aProcessList, int k, ProcessList * aVariant, vector<TopVariant> * aTop);
+
+/**
+ * @brief Decode the case ids of a top variant
+ * @param: const TopVariant *, a top variant
+ * @return the case ids, ascending
+ */
+vector<int> topVariantCases(const TopVariant * aTopVariant);
+
+
+/*
+ * Activity histograms
+ */
+
+/**
+ * @brief Count the start and end activities of the cases of a process list, in one pass
+ * @param: ProcessList *, a process list
+ * @param: vector<int> *, the number of cases starting with each activity code (indexed by code)
+ * @param: vector<int> *, the number of cases ending with each activity code (indexed by code)
+ */
+void startEndHistograms(ProcessList * aList, vector<int> * aStarts, vector<int> * anEnds);
+
+/**
+ * @brief Same as startEndHistograms, the cases are split between several threads
+ * and the histograms of the threads are summed
+ * @param: ProcessList *, a process list
+ * @param: vector<int> *, the number of cases starting with each activity code (indexed by code)
+ * @param: vector<int> *, the number of cases ending with each activity code (indexed by code)
+ * @param: int, the number of threads (hardware concurrency if <= 0)
+ */
+void startEndHistogramsParallel(ProcessList * aList, vector<int> * aStarts, vector<int> * anEnds, int nbThreads);
+
+
+/*
+ * Directly-follows graph
+ */
+
+/**
+ * @brief Build the directly-follows graph of a store in one pass over its code array
+ * The cases are split between several threads, each one counting in its own matrix,
+ * and the matrices are summed at the end
+ * @param: const EventStore *, the store
+ * @param: DirectlyFollowsGraph *, the graph to fill
+ * @param: int, the number of threads (hardware concurrency if <= 0)
+ */
+void buildDfg(const EventStore * aStore, DirectlyFollowsGraph * aGraph, int nbThreads);
+
+/**
+ * @brief Build the directly-follows graph of a process list (through its event store)
+ * @param: ProcessList *, the process list
+ * @param: DirectlyFollowsGraph *, the graph to fill
+ * @param: int, the number of threads (hardware concurrency if <= 0)
+ */
+void buildDfg(ProcessList * aList, DirectlyFollowsGraph * aGraph, int nbThreads);
+
+/**
+ * @brief Get the number of times an activity directly follows another one
+ * @param: const DirectlyFollowsGraph *, the graph
+ * @param: int, the code of the first activity
+ * @param: int, the code of the following activity
+ * @return the number of transitions, 0 if a code is unknown to the graph
+ */
+int64_t dfgEdge(const DirectlyFollowsGraph * aGraph, int aFrom, int aTo);
+
+
+/*
+ * Duration statistics
+ */
+
+/**
+ * @brief Add a value to a quantile sketch
+ * @param: QuantileSketch *, the sketch
+ * @param: double, the value
+ */
+void sketchAdd(QuantileSketch * aSketch, double aValue);
+
+/**
+ * @brief Add the values of a sketch to another one (the result is the sketch of both sets of values)
+ * @param: QuantileSketch *, the sketch receiving the values
+ * @param: const QuantileSketch *, the sketch to add
+ */
+void sketchMerge(QuantileSketch * aSketch, const QuantileSketch * anOther);
+
+/**
+ * @brief Estimate a quantile of the values of a sketch (exact while no level has been compacted)
+ * @param: const QuantileSketch *, the sketch
+ * @param: double, the quantile, between 0 (min) and 1 (max), 0.5 for the median
+ * @return the estimated value, 0 if the sketch is empty
+ */
+double sketchQuantile(const QuantileSketch * aSketch, double aQuantile);
+
+/**
+ * @brief Get the mean of the values of a sketch
+ * @param: const QuantileSketch *, the sketch
+ * @return the mean, 0 if the sketch is empty
+ */
+double sketchMean(const QuantileSketch * aSketch);
+
+/**
+ * @brief Compute the case durations and the waiting times of a store from the parsed timestamps
+ * Events without a timestamp are ignored and break the chain: no waiting time is recorded
+ * for the transitions into or out of them. The cases are split between several threads
+ * and the sketches of the threads are merged
+ * @param: const EventStore *, the store
+ * @param: DurationStatistics *, the statistics to fill
+ * @param: int, the number of threads (hardware concurrency if <= 0)
+ */
+void durationStatistics(const EventStore * aStore, DurationStatistics * aStatistics, int nbThreads);
+
+/**
+ * @brief Compute the duration statistics of a process list (through its event store)
+ * @param: ProcessList *, the process list
+ * @param: DurationStatistics *, the statistics to fill
+ * @param: int, the number of threads (hardware concurrency if <= 0)
+ */
+void durationStatistics(ProcessList * aList, DurationStatistics * aStatistics, int nbThreads);
+
+/**
+ * @brief Get the waiting times of a transition
+ * @param: const DurationStatistics *, the statistics
+ * @param: int, the code of the first activity
+ * @param: int, the code of the following activity
+ * @return the sketch of the waiting times, nullptr if the transition never happens
+ */
+const QuantileSketch * transitionWaitingTimes(const DurationStatistics * aStatistics, int aFrom, int aTo);
+
+/**
+ * @brief Display the mean, min, max, p50, p90 and p99 of the case durations and waiting times
+ * @param: const DurationStatistics *, the statistics
+ */
+void displayDurationStatistics(const DurationStatistics * aStatistics);
+
+
+/*
+ * Live tail mode
+ */
+
+/**
+ * @brief Start following a log file: variants are tracked on the list (trackVariants),
+ * the histograms are computed from the current content of the list and the file is watched
+ * with inotify on Linux (polled otherwise). Nothing is read before the first followPoll
+ * @param: LogFollower *, the follower to initialize
+ * @param: ProcessList *, the process list receiving the events of the file
+ * @param: string, the file name
+ * @return true if the file can be opened, false otherwise
+ */
+bool followOpen(LogFollower * aFollower, ProcessList * aList, string aFileName);
+
+/**
+ * @brief Parse the bytes appended to the file since the last call (a batch)
+ * Only complete lines are added, an incomplete last line waits for the next batch.
+ * The list, its variant trie and the histograms of the follower are up to date when it returns.
+ * A file shorter than the bytes already read (truncated) is read again from the beginning,
+ * as well as another file under the same name (rotation: other device or inode), which is watched instead
+ * @param: LogFollower *, the follower
+ * @param: ProcessList *, the process list given to followOpen
+ * @return the number of events added by this batch, -1 if the file can't be read
+ */
+int followPoll(LogFollower * aFollower, ProcessList * aList);
+
+/**
+ * @brief Wait until the file is modified, moved or deleted (inotify) or its size or identity changes (polling every 100 ms).
+ * After a move or a deletion the name is polled until followPoll finds the new file
+ * @param: LogFollower *, the follower
+ * @param: int, the maximum waiting time in milliseconds
+ * @return true if the file changed, false on timeout
+ */
+bool followWait(LogFollower * aFollower, int aTimeoutMs);
+
+/**
+ * @brief Stop watching the file (the list and the histograms are kept)
+ * @param: LogFollower *, the follower
+ */
+void followClose(LogFollower * aFollower);
+
+/**
+ * @brief Follow a log file like tail -f: each batch of appended lines is added to the list,
+ * then the callback is called to query the current state, until it returns false
+ * @param: ProcessList *, the process list
+ * @param: string, the file name
+ * @param: function<bool(ProcessList *, const LogFollower *)>, called after each batch, false to stop following
+ * @param: int, the maximum waiting time between two batches in milliseconds (the callback is called even without new events)
+ */
+void followLog(ProcessList * aList, string aFileName, function<bool(ProcessList *, const LogFollower *)> aBatchCallback, int aTimeoutMs);
+
+
+/*
+ * Memory-bounded streaming
+ */
+
+/**
+ * @brief Initialize a streaming analysis (the aggregates are emptied)
+ * @param: CaseStream *, the stream
+ * @param: vector<string>, the names of the activities finishing a case (e.g. "e")
+ * @param: int64_t, the inactivity timeout in seconds of log time, 0 for no timeout
+ */
+void streamOpen(CaseStream * aStream, vector<string> anEndActivities, int64_t aTimeout);
+
+/**
+ * @brief Add an event to a streaming analysis
+ * The open cases whose last event is older than the timeout (against the latest timestamp) are finished first.
+ * A case is finished after an end activity, a later event with the same id starts a new case.
+ * A finished case is added to the variants, the graph and the lengths, then its activities are freed
+ * @param: CaseStream *, the stream
+ * @param: int, the process id
+ * @param: Activity *, the activity, allocated with new (owned by the stream afterwards)
+ */
+void streamEvent(CaseStream * aStream, int aProcessId, Activity * anActivity);
+
+/**
+ * @brief Add an event to a streaming analysis from its text
+ * @param: CaseStream *, the stream
+ * @param: int, the process id
+ * @param: string, the activity name
+ * @param: string, the timestamp
+ */
+void streamEvent(CaseStream * aStream, int aProcessId, string anActivityName, string aTime);
+
+/**
+ * @brief Finish all the open cases (end of the log)
+ * @param: CaseStream *, the stream
+ */
+void streamFlush(CaseStream * aStream);
+
+/**
+ * @brief Stream all the events of a file (memory mapping, nextEvent), then finish the cases still open
+ * @param: CaseStream *, the stream, initialized by streamOpen
+ * @param: string, the file name
+ */
+void streamFile(CaseStream * aStream, string aFileName);
+
+/**
+ * @brief Free the open cases without adding them to the aggregates
+ * @param: CaseStream *, the stream
+ */
+void streamClose(CaseStream * aStream);
+
+
+/*
+ * Multi-file ingestion
+ */
+
+/**
+ * @brief List the log segments of a directory (rotated or split logs): the regular files, hidden files excepted.
+ * By default the oldest file comes first, which is the log order as long as the segments are not modified
+ * after being written. The names are compared in natural order (numbers by value: log.2 before log.10),
+ * forward for split logs, backward for logrotate where app.log is the newest segment
+ * @param: string, the directory
+ * @param: SegmentOrder, how the segments are sorted
+ * @return the paths of the segments, sorted by the given order
+ */
+vector<string> logSegments(string aDirectory, SegmentOrder anOrder = SEGMENTS_BY_TIME);
+
+/**
+ * @brief Extract all the processes from several log segments
+ * Each segment is parsed on its own thread into a partial list (at most nbThreads segments at a time),
+ * the partial lists are merged in segment order as soon as they are ready, so a case spanning
+ * several segments has its activities in segment order. The result is the same process list
+ * as extractProcesses on the concatenation of the segments.
+ * @param: ProcessList *, the process list,
+ * @param: vector<string>, the file names, in log order
+ * @param: int, the maximum number of segments parsed at the same time (hardware concurrency if <= 0)
+ */
+void extractProcesses(ProcessList * aList, vector<string> aFileNames, int nbThreads);
+
+
+/*
+ * Compressed ingestion
+ */
+
+/**
+ * @brief Check the gzip magic number at the beginning of a file
+ * Pipes and other non regular files are not read (false), so that no byte is consumed
+ * @param: string, the file name
+ * @return true if the file is a regular file compressed with gzip, false otherwise
+ */
+bool isGzipFile(string aFileName);
+
+/**
+ * @brief Extract all the processes from a gzip compressed file (several members are read one after the other)
+ * A dedicated thread decompresses the file into a bounded buffer of blocks, the calling thread
+ * parses the blocks as soon as they are filled: decompression and parsing overlap.
+ * The result is the same process list as extractProcesses on the decompressed file
+ * @param: ProcessList *, the process list,
+ * @param: string, the file name
+ */
+void extractProcessesGzip(ProcessList * aList, string aFileName);
+
+
+/*
+ * Pipelined ingestion
+ */
+
+/**
+ * @brief Extract all the processes from a file with three overlapping stages on three threads:
+ * raw block reads, tokenizing and parsing (id, activity code, timestamp), insertion in the list.
+ * The stages exchange preallocated buffers through lock-free single-producer/single-consumer rings.
+ * The result is the same process list as extractProcesses
+ * @param: ProcessList *, the process list,
+ * @param: string, the file name
+ */
+void extractProcessesPipeline(ProcessList * aList, string aFileName);
+
+
 #endif // FUNCTIONS_H
@@ -0,0 +1,354 @@
+/**
+ * @file generator.cpp
+ * @brief Deterministic generator of synthetic event logs "id activity timestamp"
+ * Usage: generator [--seed N] [--cases N] [--activities N] [--variants N] [--skew X]
+ *                  [--interleaving N] [--ids sequential|random] [--time epoch|iso|ctime] [--output file|-]
+ * The same parameters always give the same log. Each case follows one of the variants, chosen with
+ * a Zipf law of exponent skew (0 for uniform); interleaving cases are open at the same time and
+ * their events are mixed, the timestamps increase along the log
+ * @date 17/10/2026
+ */
+#include <iostream>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+
+using namespace std;
+
+/*
+ * Parameters of the generator
+ * seed: the seed of the random generator
+ * nbCases / nbActivities / nbVariants: the size of the log, of the activity alphabet and of the variant set
+ * skew: the exponent of the Zipf law of the variants (0 for uniform)
+ * interleaving: the number of cases open at the same time (1 for cases one after the other)
+ * randomIds: true for random distinct ids, false for sequential ids
+ * timeFormat: "epoch", "iso" (2023-02-03T19:44:59) or "ctime" (Fri-Feb--3-19:44:59-2023)
+ * output: the file name, "-" for the standard output
+ */
+struct GeneratorParameters
+{
+    uint64_t seed = 1;
+    int64_t nbCases = 100000;
+    int nbActivities = 5;
+    int nbVariants = 10;
+    double skew = 1.0;
+    int interleaving = 100;
+    bool randomIds = true;
+    string timeFormat = "ctime";
+    string output = "syntheticDataset.txt";
+};
+
+/*
+ * A case being written
+ * id: the id of the case
+ * variant: the variant the case follows
+ * position: the index of the next activity in the variant
+ */
+struct OpenCase
+{
+    int64_t id = 0;
+    int variant = 0;
+    int position = 0;
+};
+
+/**
+ * @brief Next value of a xorshift64* generator (the state must not be 0)
+ */
+static uint64_t nextRandom(uint64_t & aState)
+{
+    aState ^= aState >> 12;
+    aState ^= aState << 25;
+    aState ^= aState >> 27;
+    return aState * 2685821657736338717ULL;
+}
+
+/**
+ * @brief Name of an activity: a, b, ..., z, then aa, ab...
+ */
+static string activityName(int aCode)
+{
+    string name;
+    do
+    {
+        name.insert(name.begin(), (char)('a' + aCode % 26));
+        aCode = aCode / 26 - 1;
+    } while (aCode >= 0);
+    return name;
+}
+
+/**
+ * @brief Build nbVariants distinct activity sequences: the first activity (a) starts every variant,
+ * the last one ends it, the middle is drawn among the others (as in smallDataset.txt)
+ */
+static vector<vector<int>> makeVariants(const GeneratorParameters * aParameters, uint64_t & aState)
+{
+    vector<vector<int>> variants;
+    set<vector<int>> known;
+    int nbMiddle = max(aParameters->nbActivities - 2, 0);
+    for (int attempt = 0; (int)variants.size() < aParameters->nbVariants && attempt < aParameters->nbVariants * 100; ++attempt)
+    {
+        vector<int> sequence(1, 0);
+        int length = nbMiddle == 0 ? 0 : 1 + nextRandom(aState) % (2 * nbMiddle);
+        for (int i = 0; i < length; ++i)
+            sequence.push_back(1 + nextRandom(aState) % nbMiddle);
+        if (aParameters->nbActivities > 1)
+            sequence.push_back(aParameters->nbActivities - 1);
+        if (known.insert(sequence).second)
+            variants.push_back(sequence);
+    }
+    if ((int)variants.size() < aParameters->nbVariants)
+        cerr<<"Only "<<variants.size()<<" distinct variants with "<<aParameters->nbActivities<<" activities"<<endl;
+    return variants;
+}
+
+/**
+ * @brief Cumulative Zipf weights of the variants: variant i has a weight 1 / (i + 1)^skew
+ */
+static vector<double> zipfCumulative(int nbVariants, double aSkew)
+{
+    vector<double> cumulative(nbVariants);
+    double sum = 0;
+    for (int i = 0; i < nbVariants; ++i)
+    {
+        sum += 1.0 / pow(i + 1, aSkew);
+        cumulative[i] = sum;
+    }
+    for (int i = 0; i < nbVariants; ++i)
+        cumulative[i] /= sum;
+    return cumulative;
+}
+
+/**
+ * @brief Id of the case number aCase: sequential from 1, or a distinct random id below 2^31
+ * (multiplication by an odd number then xor with the seed: a bijection modulo 2^31)
+ */
+static int64_t caseId(const GeneratorParameters * aParameters, int64_t aCase)
+{
+    if (!aParameters->randomIds)
+        return aCase + 1;
+    return ((uint64_t)aCase * 2654435761ULL ^ (aParameters->seed * 40503ULL)) & 0x7fffffff;
+}
+
+/**
+ * @brief Output buffer written with fwrite by blocks of 4 Mo
+ */
+struct OutputBuffer
+{
+    FILE * file = nullptr;
+    vector<char> data = vector<char>(4 << 20);
+    size_t used = 0;
+};
+
+static void flush(OutputBuffer * aBuffer)
+{
+    fwrite(aBuffer->data.data(), 1, aBuffer->used, aBuffer->file);
+    aBuffer->used = 0;
+}
+
+static void append(OutputBuffer * aBuffer, const char * aText, size_t aLength)
+{
+    if (aBuffer->used + aLength > aBuffer->data.size())
+        flush(aBuffer);
+    memcpy(aBuffer->data.data() + aBuffer->used, aText, aLength);
+    aBuffer->used += aLength;
+}
+
+/**
+ * @brief Write an integer in decimal at the end of a text, returns the end of the written digits
+ */
+static char * writeInteger(char * aText, int64_t aValue)
+{
+    char digits[24];
+    int nbDigits = 0;
+    bool isNegative = aValue < 0;
+    uint64_t value = isNegative ? -(uint64_t)aValue : aValue;
+    do
+    {
+        digits[nbDigits++] = '0' + value % 10;
+        value /= 10;
+    } while (value != 0);
+    if (isNegative)
+        *aText++ = '-';
+    while (nbDigits > 0)
+        *aText++ = digits[--nbDigits];
+    return aText;
+}
+
+static char * writeTwoDigits(char * aText, int aValue)
+{
+    *aText++ = '0' + aValue / 10;
+    *aText++ = '0' + aValue % 10;
+    return aText;
+}
+
+/**
+ * @brief Write a timestamp (seconds since 1970) in the chosen format.
+ * The date is computed from the number of days (civil calendar) only when the day changes
+ */
+static char * writeTime(char * aText, int64_t aTimestamp, const string & aFormat)
+{
+    static const char * DAYS[7] = {"Thu", "Fri", "Sat", "Sun", "Mon", "Tue", "Wed"};
+    static const char * MONTHS[12] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    static int64_t cachedDay = INT64_MIN;
+    static int year = 0, month = 0, day = 0;
+    if (aFormat == "epoch")
+        return writeInteger(aText, aTimestamp);
+    int64_t days = aTimestamp >= 0 ? aTimestamp / 86400 : (aTimestamp - 86399) / 86400;
+    int64_t seconds = aTimestamp - days * 86400;
+    if (days != cachedDay)
+    {
+        cachedDay = days;
+        int64_t z = days + 719468;  //jours depuis le 0000-03-01
+        int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        int64_t dayOfEra = z - era * 146097;
+        int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+        day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+        month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+        year = yearOfEra + era * 400 + (month <= 2);
+    }
+    if (aFormat == "iso")
+    {
+        aText = writeInteger(aText, year);
+        *aText++ = '-';
+        aText = writeTwoDigits(aText, month);
+        *aText++ = '-';
+        aText = writeTwoDigits(aText, day);
+        *aText++ = 'T';
+    }
+    else
+    {
+        memcpy(aText, DAYS[((cachedDay % 7) + 7) % 7], 3);
+        aText[3] = '-';
+        memcpy(aText + 4, MONTHS[month - 1], 3);
+        aText[7] = '-';
+        aText += 8;
+        if (day < 10)
+            *aText++ = '-';     //ctime complète le jour par une espace
+        aText = writeInteger(aText, day);
+        *aText++ = '-';
+    }
+    aText = writeTwoDigits(aText, seconds / 3600);
+    *aText++ = ':';
+    aText = writeTwoDigits(aText, seconds / 60 % 60);
+    *aText++ = ':';
+    aText = writeTwoDigits(aText, seconds % 60);
+    if (aFormat != "iso")
+    {
+        *aText++ = '-';
+        aText = writeInteger(aText, year);
+    }
+    return aText;
+}
+
+/**
+ * @brief Read the options of the command line
+ * @return false if an option is unknown or has no value
+ */
+static bool readParameters(int argc, char ** argv, GeneratorParameters * aParameters)
+{
+    for (int i = 1; i < argc; i += 2)
+    {
+        string option = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        string value = argv[i + 1];
+        if (option == "--seed")
+            aParameters->seed = stoull(value);
+        else if (option == "--cases")
+            aParameters->nbCases = max(0LL, stoll(value));
+        else if (option == "--activities")
+            aParameters->nbActivities = max(1, stoi(value));
+        else if (option == "--variants")
+            aParameters->nbVariants = max(1, stoi(value));
+        else if (option == "--skew")
+            aParameters->skew = max(0.0, stod(value));
+        else if (option == "--interleaving")
+            aParameters->interleaving = max(1, stoi(value));
+        else if (option == "--ids" && (value == "sequential" || value == "random"))
+            aParameters->randomIds = value == "random";
+        else if (option == "--time" && (value == "epoch" || value == "iso" || value == "ctime"))
+            aParameters->timeFormat = value;
+        else if (option == "--output")
+            aParameters->output = value;
+        else
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char ** argv)
+{
+    GeneratorParameters parameters;
+    if (!readParameters(argc, argv, &parameters))
+    {
+        cerr<<"Usage: generator [--seed N] [--cases N] [--activities N] [--variants N] [--skew X]"<<endl
+            <<"                 [--interleaving N] [--ids sequential|random] [--time epoch|iso|ctime] [--output file|-]"<<endl;
+        return 1;
+    }
+    uint64_t state = parameters.seed * 0x9E3779B97F4A7C15ULL + 0x2545F4914F6CDD1DULL;
+    if (state == 0)
+        state = 1;
+    vector<vector<int>> variants = makeVariants(&parameters, state);
+    vector<double> cumulative = zipfCumulative(variants.size(), parameters.skew);
+    vector<string> names;
+    for (int i = 0; i < parameters.nbActivities; ++i)
+        names.push_back(' ' + activityName(i) + ' ');
+
+    OutputBuffer buffer;
+    buffer.file = parameters.output == "-" ? stdout : fopen(parameters.output.c_str(), "wb");
+    if (buffer.file == nullptr)
+    {
+        cerr<<"Erreur d'ouverture du fichier "<<parameters.output<<endl;
+        return 1;
+    }
+    vector<OpenCase> openCases;
+    int64_t nbStarted = 0;
+    int64_t nbEvents = 0;
+    int64_t timestamp = 1675450000;     //2023-02-03
+    auto startCase = [&]() {
+        OpenCase aCase;
+        aCase.id = caseId(&parameters, nbStarted++);
+        double draw = (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+        aCase.variant = lower_bound(cumulative.begin(), cumulative.end(), draw) - cumulative.begin();
+        aCase.variant = min(aCase.variant, (int)variants.size() - 1);
+        return aCase;
+    };
+    while ((int)openCases.size() < parameters.interleaving && nbStarted < parameters.nbCases)
+        openCases.push_back(startCase());
+    char line[128];
+    while (!openCases.empty())
+    {
+        size_t slot = nextRandom(state) % openCases.size();
+        OpenCase & aCase = openCases[slot];
+        const string & name = names[variants[aCase.variant][aCase.position++]];
+        timestamp += 1 + nextRandom(state) % 60;
+        char * end = writeInteger(line, aCase.id);
+        memcpy(end, name.data(), name.size());
+        end = writeTime(end + name.size(), timestamp, parameters.timeFormat);
+        *end++ = '\n';
+        append(&buffer, line, end - line);
+        nbEvents++;
+        if (aCase.position == (int)variants[aCase.variant].size())     //cas terminé : un nouveau prend sa place
+        {
+            if (nbStarted < parameters.nbCases)
+                aCase = startCase();
+            else
+            {
+                openCases[slot] = openCases.back();
+                openCases.pop_back();
+            }
+        }
+    }
+    flush(&buffer);
+    if (buffer.file != stdout)
+        fclose(buffer.file);
+    cerr<<nbStarted<<" cases, "<<nbEvents<<" events, "<<variants.size()<<" variants written"<<endl;
+    return 0;
+}
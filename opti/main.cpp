@@ -15,13 +15,23 @@ using namespace std;
 
 /**
 * @brief Function to execute the analysis of the log file.
+* @param withSnapshot: reload the extraction from largeDataset.snapshot, or write it there after a fresh extraction
 **/
-void launchProcessAnalysis()
+void launchProcessAnalysis(bool withSnapshot)
 {
     ProcessList * aProcessList = new ProcessList;
     aProcessList->size = 0;
+    enableArena(aProcessList);
+    trackVariants(aProcessList);    //variants calculés pendant l'extraction
     chrono::time_point<std::chrono::high_resolution_clock> startTime = getTime();
-    extractProcesses(aProcessList,"largeDataset.txt");
+    if (withSnapshot and loadSnapshot(aProcessList,"largeDataset.snapshot","largeDataset.txt"))
+        cout<<"Snapshot loaded from largeDataset.snapshot"<<endl;
+    else
+    {
+        extractProcessesParallel(aProcessList,"largeDataset.txt",0);
+        if (withSnapshot and saveSnapshot(aProcessList,"largeDataset.snapshot","largeDataset.txt"))
+            cout<<"Snapshot written to largeDataset.snapshot"<<endl;
+    }
     chrono::time_point<std::chrono::high_resolution_clock> endTime = getTime();
     cout<<"Processes extract in "<<calculateDuration(startTime,endTime)<<'s'<<endl;
     cout<<aProcessList->size<<" process add to the processList"<<endl;
@@ -39,11 +49,17 @@ void launchProcessAnalysis()
     displayActivitiesList(activityList2);
     clear(activityList2);
 
+    cout<<endl;
+    DurationStatistics durations;
+    durationStatistics(aProcessList,&durations,0);
+    displayDurationStatistics(&durations);
+
     cout<<endl<<endl;
     ProcessList * aVariant = new ProcessList;
     aVariant->size = 0;
+    enableArena(aVariant);
     chrono::time_point<std::chrono::high_resolution_clock> startTime2 = getTime();
-    variants(aProcessList,aVariant);
+    trieVariants(aProcessList,aVariant);
     chrono::time_point<std::chrono::high_resolution_clock> endTime2 = getTime();
     cout<<"Variants extract in "<<calculateDuration(startTime2,endTime2)<<'s'<<endl;
 
@@ -60,8 +76,26 @@ void launchProcessAnalysis()
     clear(vActivityList2);
 
     cout<<endl<<"Clearing"<<endl;
-    //clear(aVariant);
-    //clear(aProcessList);
+    clear(aVariant);
+    clear(aProcessList);
+}
+
+/**
+* @brief Follows a growing log file like tail -f.
+* After each batch of appended lines the number of cases, of events and of variants is displayed.
+**/
+void launchFollowMode()
+{
+    ProcessList * aProcessList = new ProcessList;
+    enableArena(aProcessList);
+    followLog(aProcessList,"largeDataset.txt",[](ProcessList * aList, const LogFollower * aFollower) {
+        int nbVariants = 0;
+        for (size_t i = 0; i < aList->variantTrie->nodes.size(); ++i)
+            nbVariants += aList->variantTrie->nodes[i].frequency > 0;
+        cout<<aList->size<<" processus, "<<aFollower->nbEvents<<" évènements, "<<nbVariants<<" variants"<<endl;
+        return true;
+    },1000);
+    clear(aProcessList);
 }
 
 /**
@@ -88,10 +122,31 @@ void launchTests()
                            test_startActivities,
                            test_variants,
                            test_insertActivity,
-                           test_processAlreadyExists
+                           test_processAlreadyExists,
+                           test_extractProcessesMapped,
+                           test_extractProcessesParallel,
+                           test_vectorizedScanning,
+                           test_extractProcessesStream,
+                           test_parseTimestamp,
+                           test_processIndex,
+                           test_eventStore,
+                           test_arena,
+                           test_snapshot,
+                           test_variantTrie,
+                           test_variantsParallel,
+                           test_trackVariants,
+                           test_topVariants,
+                           test_activityHistograms,
+                           test_buildDfg,
+                           test_durationStatistics,
+                           test_followLog,
+                           test_streamCases,
+                           test_extractProcessesSegments,
+                           test_extractProcessesGzip,
+                           test_extractProcessesPipeline
                            };
     int i = 0;
-    int nbTest = 16;
+    int nbTest = 37;
     bool isValid = true;
     do {  //boucle de validation entre chaque test avec un tableau de pointeur sur les fonctions.
         cout<<endl<<"Passer a la suite :";
@@ -128,8 +183,11 @@ int main()
 
     // Uncomment the line below to run tests
     //launchTests();
-    // Start the process analysis
-    launchProcessAnalysis();
+    // Start the process analysis (pass true to cache the extraction in largeDataset.snapshot)
+    launchProcessAnalysis(false);
+
+    // Uncomment the line below to follow the log file as it grows
+    //launchFollowMode();
 
     return 0;
 }
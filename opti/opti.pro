@@ -1,8 +1,10 @@
 TEMPLATE = app
-CONFIG += console c++17
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
+LIBS += -lz
+
 SOURCES += \
         functions.cpp \
         main.cpp \
@@ -9,11 +9,18 @@
 #include <Windows.h>
 #else
 #include <unistd.h>
+#include <sys/stat.h>
 #endif
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <thread>
+#include <zlib.h>
 
 #include "typeDef.h"
 #include "functions.h"
@@ -122,6 +129,66 @@ ProcessList * generateDuplicateProcessList()
     return l;
 }
 
+/**
+ * @brief Compare two process lists: same size, same processes in the same order
+ * with the same activities (name and time)
+ */
+bool sameProcessList(ProcessList * l1, ProcessList * l2)
+{
+    if (l1->size != l2->size)
+        return false;
+    Process * p1 = l1->firstProcess;
+    Process * p2 = l2->firstProcess;
+    while (p1 != nullptr and p2 != nullptr)
+    {
+        if (p1->id != p2->id or p1->nbActivities != p2->nbActivities)
+            return false;
+        Activity * a1 = p1->firstActivity;
+        Activity * a2 = p2->firstActivity;
+        while (a1 != nullptr and a2 != nullptr)
+        {
+            if (activityCode(a1) != activityCode(a2) or getActivityTimestamp(a1) != getActivityTimestamp(a2) or a1->time != a2->time)
+                return false;
+            a1 = a1->nextActivity;
+            a2 = a2->nextActivity;
+        }
+        if (a1 != a2)
+            return false;
+        p1 = p1->nextProcess;
+        p2 = p2->nextProcess;
+    }
+    return p1 == p2;
+}
+
+/**
+ * @brief Write the lines aFirst to aLast - 1 of the test log: line i is an event of the case
+ * (i * 7919) % nbIds at time i, the activities a to d follow an irregular pattern.
+ * With withBadLines, every 1000th event has an unreadable date and an invalid line follows every 4999th event
+ */
+void writeTestLines(ostream & anOutput, int aFirst, int aLast, int nbIds, bool withBadLines)
+{
+    for (int i=aFirst; i<aLast; i++)
+    {
+        anOutput << (i * 7919) % nbIds << ' ' << (char)('a' + ((int64_t)i * i / 7 + i / 50) % 4) << ' ';
+        if (withBadLines and i % 1000 == 0)
+            anOutput << "not-a-date-" << i << endl;
+        else if (withBadLines and i % 4999 == 0)
+            anOutput << endl << "invalid" << endl;
+        else
+            anOutput << i << endl;
+    }
+}
+
+/**
+ * @brief Write the test log in FILENAME_TEST: nbLines events of nbIds interleaved cases,
+ * which overlap the boundaries of the chunks, batches and segments
+ */
+void writeTestLog(int nbLines, int nbIds)
+{
+    ofstream of(FILENAME_TEST);
+    writeTestLines(of, 0, nbLines, nbIds, false);
+}
+
 /*
  * Utility functions
  */
@@ -180,6 +247,23 @@ void test_nbOfLines()
         failed++;
     }
     f.close();
+    of.open(FILENAME_TEST);
+    for (int i=0; i<10; i++)
+    {
+        of << i << ' ' << string(300 + i, 'x') << endl;
+    }
+    of << "no final newline";
+    of.close();
+    if (nbOfLines(FILENAME_TEST) == 11)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: file 11 lines longer than 256 characters" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: file 11 lines longer than 256 characters" << endl;
+        failed++;
+    }
     cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
     cout << "********* Finished testing of nbOfLine() *********" << endl;
 }
@@ -375,7 +459,7 @@ void test_addActivity()
         cout << RED << "FAIL!" << RESET << " \t: set nbActivities at 1 when adding activity a,1 in empty list" << endl;
         failed++;
     }
-    if (p->firstActivity->name == "a")
+    if (getActivityName(p->firstActivity) == "a")
     {
         cout << GREEN << "PASS" << RESET << " \t: set name at a when adding activity a,1 in empty list" << endl;
         pass++;
@@ -385,7 +469,7 @@ void test_addActivity()
         cout << RED << "FAIL!" << RESET << " \t: set name at a when adding activity a,1 in empty list" << endl;
         failed++;
     }
-    if (p->firstActivity->time =="1")
+    if (p->firstActivity->timestamp == 1)
     {
         cout << GREEN << "PASS" << RESET << " \t: set time at 1 when adding activity a,1 in empty list" << endl;
         pass++;
@@ -406,7 +490,7 @@ void test_addActivity()
         cout << RED << "FAIL!" << RESET << " \t: set nbActivities at 2 when adding activity b,2 in <(a,1)> list" << endl;
         failed++;
     }
-    if (p->firstActivity->nextActivity->name == "b")
+    if (getActivityName(p->firstActivity->nextActivity) == "b")
     {
         cout << GREEN << "PASS" << RESET << " \t: set name at b when adding activity b,2 in <(a,1)> list" << endl;
         pass++;
@@ -416,7 +500,7 @@ void test_addActivity()
         cout << RED << "FAIL!" << RESET << " \t: set name at b when adding activity b,2 in <(a,1)> list" << endl;
         failed++;
     }
-    if (p->firstActivity->nextActivity->time =="2")
+    if (p->firstActivity->nextActivity->timestamp == 2)
     {
         cout << GREEN << "PASS" << RESET << " \t: set time at 2 when adding activity b,2 in <(a,1)> list" << endl;
         pass++;
@@ -535,7 +619,7 @@ void test_addProcess()
         cout << RED << "FAIL!" << RESET << " \t: set nextProcess at nullptr when adding process (<id=123,a,1>) in empty process list" << endl;
         failed++;
     }
-    if (l->firstProcess->firstActivity->name == "a")
+    if (getActivityName(l->firstProcess->firstActivity) == "a")
     {
         cout << GREEN << "PASS" << RESET << " \t: set name at a when adding process (<id=123,a,1>) in empty process list" << endl;
         pass++;
@@ -545,7 +629,7 @@ void test_addProcess()
         cout << RED << "FAIL!" << RESET << " \t: set name at a when adding process (<id=123,a,1>) in empty process list" << endl;
         failed++;
     }
-    if (l->firstProcess->firstActivity->time == "1")
+    if (l->firstProcess->firstActivity->timestamp == 1)
     {
         cout << GREEN << "PASS" << RESET << " \t: set time at 1 when adding process (<id=123,a,1>) in empty process list" << endl;
         pass++;
@@ -609,7 +693,7 @@ void test_insertProcessActivity()
         cout << RED << "FAIL!" << RESET << " \t: set nbActivites at 2 of process id=123 when adding activity (b,2) at process <id=123, (a,1)>" << endl;
         failed++;
     }
-    if (l->firstProcess->firstActivity->nextActivity->name == "b")
+    if (getActivityName(l->firstProcess->firstActivity->nextActivity) == "b")
     {
         cout << GREEN << "PASS" << RESET << " \t: set name at b when adding activity (b,2) at process <id=123, (a,1)>" << endl;
         pass++;
@@ -619,7 +703,7 @@ void test_insertProcessActivity()
         cout << RED << "FAIL!" << RESET << " \t: set name at b when adding activity (b,2) at process <id=123, (a,1)>" << endl;
         failed++;
     }
-    if (l->firstProcess->firstActivity->nextActivity->time == "2")
+    if (l->firstProcess->firstActivity->nextActivity->timestamp == 2)
     {
         cout << GREEN << "PASS" << RESET << " \t: set time at 2 when adding activity (b,2) at process <id=123, (a,1)>" << endl;
         pass++;
@@ -772,7 +856,7 @@ void test_endActivities()
         cout << RED << "FAIL!" << RESET << " \t: number of activities found = 2" << endl;
         failed++;
     }
-    if (p->firstActivity->name == "b" and p->firstActivity->nextActivity->name == "c")
+    if (getActivityName(p->firstActivity) == "b" and getActivityName(p->firstActivity->nextActivity) == "c")
     {
         cout << GREEN << "PASS" << RESET << " \t: <b, c> activities found" << endl;
         pass++;
@@ -834,12 +918,12 @@ void test_extractProcesses()
         cout << RED << "FAIL!" << RESET << " \t: size of the first process extracted (3)" << endl;
         failed++;
     }
-    if (l->firstProcess->firstActivity->name == "a" and
-        l->firstProcess->firstActivity->time == "3" and
-        l->firstProcess->firstActivity->nextActivity->name == "b" and
-        l->firstProcess->firstActivity->nextActivity->time == "5" and
-        l->firstProcess->firstActivity->nextActivity->nextActivity->name == "c" and
-        l->firstProcess->firstActivity->nextActivity->nextActivity->time == "6")
+    if (getActivityName(l->firstProcess->firstActivity) == "a" and
+        l->firstProcess->firstActivity->timestamp == 3 and
+        getActivityName(l->firstProcess->firstActivity->nextActivity) == "b" and
+        l->firstProcess->firstActivity->nextActivity->timestamp == 5 and
+        getActivityName(l->firstProcess->firstActivity->nextActivity->nextActivity) == "c" and
+        l->firstProcess->firstActivity->nextActivity->nextActivity->timestamp == 6)
     {
         cout << GREEN << "PASS" << RESET << " \t: first process extracted <(a,3), (b,5), (c,6)>" << endl;
         pass++;
@@ -869,8 +953,8 @@ void test_extractProcesses()
         cout << RED << "FAIL!" << RESET << " \t: size of the second process extracted (1)" << endl;
         failed++;
     }
-    if (l->firstProcess->nextProcess->firstActivity->name == "b" and
-        l->firstProcess->nextProcess->firstActivity->time == "2")
+    if (getActivityName(l->firstProcess->nextProcess->firstActivity) == "b" and
+        l->firstProcess->nextProcess->firstActivity->timestamp == 2)
     {
         cout << GREEN << "PASS" << RESET << " \t: second process extracted <(b,2)>" << endl;
         pass++;
@@ -900,10 +984,10 @@ void test_extractProcesses()
         cout << RED << "FAIL!" << RESET << " \t: size of the third process extracted (2)" << endl;
         failed++;
     }
-    if (l->firstProcess->nextProcess->nextProcess->firstActivity->name == "a" and
-        l->firstProcess->nextProcess->nextProcess->firstActivity->time == "1" and
-        l->firstProcess->nextProcess->nextProcess->firstActivity->nextActivity->name == "b" and
-        l->firstProcess->nextProcess->nextProcess->firstActivity->nextActivity->time == "4")
+    if (getActivityName(l->firstProcess->nextProcess->nextProcess->firstActivity) == "a" and
+        l->firstProcess->nextProcess->nextProcess->firstActivity->timestamp == 1 and
+        getActivityName(l->firstProcess->nextProcess->nextProcess->firstActivity->nextActivity) == "b" and
+        l->firstProcess->nextProcess->nextProcess->firstActivity->nextActivity->timestamp == 4)
     {
         cout << GREEN << "PASS" << RESET << " \t: third process extracted <(a,1), (b,4)>" << endl;
         pass++;
@@ -935,7 +1019,7 @@ void test_startActivities()
         cout << RED << "FAIL!" << RESET << " \t: number of activities found = 2" << endl;
         failed++;
     }
-    if (p->firstActivity->name == "a" and p->firstActivity->nextActivity->name == "b")
+    if (getActivityName(p->firstActivity) == "a" and getActivityName(p->firstActivity->nextActivity) == "b")
     {
         cout << GREEN << "PASS" << RESET << " \t: <a, b> activities found" << endl;
         pass++;
@@ -969,12 +1053,12 @@ void test_variants()
         cout << RED << "FAIL!" << RESET << " \t: size of variant without duplicated processes" << endl;
         failed++;
     }
-    if (v->firstProcess->firstActivity->name == "a" and
-        v->firstProcess->firstActivity->nextActivity->name == "b" and
-        v->firstProcess->nextProcess->firstActivity->name == "b" and
-        v->firstProcess->nextProcess->nextProcess->firstActivity->name == "a" and
-        v->firstProcess->nextProcess->nextProcess->firstActivity->nextActivity->name == "b" and
-        v->firstProcess->nextProcess->nextProcess->firstActivity->nextActivity->nextActivity->name == "c" and
+    if (getActivityName(v->firstProcess->firstActivity) == "a" and
+        getActivityName(v->firstProcess->firstActivity->nextActivity) == "b" and
+        getActivityName(v->firstProcess->nextProcess->firstActivity) == "b" and
+        getActivityName(v->firstProcess->nextProcess->nextProcess->firstActivity) == "a" and
+        getActivityName(v->firstProcess->nextProcess->nextProcess->firstActivity->nextActivity) == "b" and
+        getActivityName(v->firstProcess->nextProcess->nextProcess->firstActivity->nextActivity->nextActivity) == "c" and
         v->firstProcess->firstActivity->nextActivity->nextActivity == nullptr)
     {
         cout << GREEN << "PASS" << RESET << " \t: variants found in dataset without duplicated processes" << endl;
@@ -990,8 +1074,13 @@ void test_variants()
     l = new ProcessList;
     v = new ProcessList;
     l = generateDuplicateProcessList();
+    Process * duplicate = new Process;  //dernier processus <b>, doublon de 456
+    duplicate->id = 999;
+    addActivity(duplicate, "b", "7");
+    l->firstProcess->nextProcess->nextProcess->nextProcess = duplicate;
+    l->size++;
     variants(l, v);
-    if (v->size == 2)
+    if (v->size == 3)
     {
         cout << GREEN << "PASS" << RESET << " \t: size of variant with duplicated processes" << endl;
         pass++;
@@ -1001,10 +1090,13 @@ void test_variants()
         cout << RED << "FAIL!" << RESET << " \t: size of variant with duplicated processes" << endl;
         failed++;
     }
-    if (v->firstProcess->firstActivity->name == "b" and
-        v->firstProcess->nextProcess->firstActivity->name == "a" and
-        v->firstProcess->nextProcess->firstActivity->nextActivity->name == "b" and
-        v->firstProcess->nextProcess->firstActivity->nextActivity->nextActivity->name == "c")
+    if (getActivityName(v->firstProcess->firstActivity) == "a" and v->firstProcess->frequency == 1 and
+        getActivityName(v->firstProcess->nextProcess->firstActivity) == "b" and v->firstProcess->nextProcess->frequency == 2 and
+        v->firstProcess->nextProcess->id == 456 and
+        getActivityName(v->firstProcess->nextProcess->nextProcess->firstActivity) == "a" and
+        getActivityName(v->firstProcess->nextProcess->nextProcess->firstActivity->nextActivity) == "b" and
+        getActivityName(v->firstProcess->nextProcess->nextProcess->firstActivity->nextActivity->nextActivity) == "c" and
+        v->firstProcess->nextProcess->nextProcess->frequency == 1)
     {
         cout << GREEN << "PASS" << RESET << " \t: variants found in dataset with duplicated processes" << endl;
         pass++;
@@ -1016,6 +1108,51 @@ void test_variants()
     }
     clear(v);
     clear(l);
+    ofstream of(FILENAME_TEST);
+    for (int i=0; i<5000; i++)  //beaucoup de cas, peu de variants
+        of << i / 4 << ' ' << (char)('a' + (i * i / 4 + i / 12) % 3) << ' ' << i << endl;
+    of.close();
+    l = new ProcessList;
+    v = new ProcessList;
+    extractProcessesMapped(l, FILENAME_TEST);
+    variants(l, v);
+    int nbCasesFound = 0;
+    bool isUnique = true;
+    for (Process * ptr = v->firstProcess; ptr != nullptr; ptr = ptr->nextProcess)
+    {
+        nbCasesFound += ptr->frequency;
+        ProcessList others;
+        others.firstProcess = ptr->nextProcess;
+        others.size = 1;
+        isUnique = isUnique and !processAlreadyExists(&others, ptr);
+    }
+    if (v->size > 1 and nbCasesFound == l->size and isUnique)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: " << v->size << " distinct variants covering the " << l->size << " cases" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: " << v->size << " distinct variants covering the " << l->size << " cases" << endl;
+        failed++;
+    }
+    clear(v);
+    clear(l);
+    l = new ProcessList;
+    v = new ProcessList;
+    variants(l, v);
+    if (v->size == 0 and v->firstProcess == nullptr)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: no variant in an empty list" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: no variant in an empty list" << endl;
+        failed++;
+    }
+    clear(v);
+    clear(l);
     cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
     cout << "********* Finished testing of test_variants() *********" << endl;
 }
@@ -1311,3 +1448,1886 @@ void test_processAlreadyExists()
     cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
     cout << "********* Finished testing of processAlreadyExists() *********" << endl;
 }
+
+/*
+ * Memory-mapped ingestion
+ */
+void test_extractProcessesMapped()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of extractProcessesMapped() *********" << endl;
+    ofstream of(FILENAME_TEST);
+    of << "123 a 1" << endl;
+    of << "456 b 2" << endl;
+    of << "789 a 3" << endl;
+    of << "123 b 4" << endl;
+    of << "789 b 5" << endl;
+    of << "789 c 6" << endl;
+    of.close();
+    ProcessList * expected = new ProcessList;
+    extractProcesses(expected, FILENAME_TEST);
+    ProcessList * l = new ProcessList;
+    extractProcessesMapped(l, FILENAME_TEST);
+    if (sameProcessList(l, expected))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: same process list as extractProcesses" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: same process list as extractProcesses" << endl;
+        failed++;
+    }
+    clear(l);
+    of.open(FILENAME_TEST);
+    of << "123 a 1\r\n\n456   b\t2\r\n789 a 3\n123 b 4\n789 b 5\n789 c 6";
+    of.close();
+    l = new ProcessList;
+    extractProcessesMapped(l, FILENAME_TEST);
+    if (sameProcessList(l, expected))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: CRLF, blank lines and missing final newline" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: CRLF, blank lines and missing final newline" << endl;
+        failed++;
+    }
+    clear(l);
+    clear(expected);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of extractProcessesMapped() *********" << endl;
+}
+
+/*
+ * Parallel ingestion
+ */
+void test_extractProcessesParallel()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of extractProcessesParallel() *********" << endl;
+    ofstream of(FILENAME_TEST);
+    for (int i=0; i<5000; i++)  //processus entrelacés, qui chevauchent les frontières des morceaux
+    {
+        of << (i * 7919) % 613 << ' ' << (char)('a' + i % 5) << ' ' << i << endl;
+    }
+    of.close();
+    ProcessList * expected = new ProcessList;
+    extractProcesses(expected, FILENAME_TEST);
+    int nbThreads[4] = {1, 2, 7, 64};
+    for (int t=0; t<4; t++)
+    {
+        ProcessList * l = new ProcessList;
+        extractProcessesParallel(l, FILENAME_TEST, nbThreads[t]);
+        if (sameProcessList(l, expected))
+        {
+            cout << GREEN << "PASS" << RESET << " \t: same process list as extractProcesses with " << nbThreads[t] << " threads" << endl;
+            pass++;
+        }
+        else
+        {
+            cout << RED << "FAIL!" << RESET << " \t: same process list as extractProcesses with " << nbThreads[t] << " threads" << endl;
+            failed++;
+        }
+        clear(l);
+    }
+    clear(expected);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of extractProcessesParallel() *********" << endl;
+}
+
+/*
+ * Vectorized scanning
+ */
+void test_vectorizedScanning()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of countNewlines(), findSeparator(), parseId() *********" << endl;
+    string buffer;
+    unsigned int seed = 42;
+    for (int i=0; i<100000; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        const char chars[8] = {'a', 'b', ' ', '\n', '\t', 'z', '\r', '9'};
+        buffer += chars[(seed >> 16) % 8];
+    }
+    int initialLevel = scannerLevel();
+    for (int level=initialLevel; level>=0; level--)
+    {
+        setScannerLevel(level);
+        bool isCorrect = true;
+        for (size_t size=0; size<buffer.size(); size = size * 3 + 1)    //toutes les tailles de fin de buffer
+        {
+            size_t expected = 0;
+            for (size_t i=0; i<size; i++)
+                expected += buffer[i] == '\n';
+            if (countNewlines(buffer.data(), size) != expected)
+                isCorrect = false;
+        }
+        for (size_t start=0; start<200; start++)
+        {
+            string token = string(start, 'k');
+            const char * end = token.data() + token.size();
+            if (findSeparator(token.data(), end) != end)
+                isCorrect = false;
+            token += " next";
+            if (findSeparator(token.data(), token.data() + token.size()) != token.data() + start)
+                isCorrect = false;
+        }
+        if (isCorrect)
+        {
+            cout << GREEN << "PASS" << RESET << " \t: scanner level " << level << " matches scalar results" << endl;
+            pass++;
+        }
+        else
+        {
+            cout << RED << "FAIL!" << RESET << " \t: scanner level " << level << " matches scalar results" << endl;
+            failed++;
+        }
+    }
+    setScannerLevel(initialLevel);
+    string line = "-34594400 a";
+    const char * cursor = line.data();
+    int id = 0;
+    if (parseId(cursor, line.data() + line.size(), &id) and id == -34594400 and *cursor == ' ')
+    {
+        cout << GREEN << "PASS" << RESET << " \t: parseId reads -34594400" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: parseId reads -34594400" << endl;
+        failed++;
+    }
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of countNewlines(), findSeparator(), parseId() *********" << endl;
+}
+
+/*
+ * Streaming ingestion
+ */
+void test_extractProcessesStream()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of extractProcessesStream() *********" << endl;
+    ofstream of(FILENAME_TEST);
+    for (int i=0; i<100000; i++)  //plus d'un bloc de lecture : des lignes sont coupées entre deux blocs
+    {
+        of << (i * 7919) % 613 << ' ' << (char)('a' + i % 5) << ' ' << i << endl;
+    }
+    of.close();
+    ProcessList * expected = new ProcessList;
+    extractProcesses(expected, FILENAME_TEST);
+    ProcessList * l = new ProcessList;
+    extractProcessesStream(l, FILENAME_TEST);
+    if (sameProcessList(l, expected))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: same process list as extractProcesses from a file" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: same process list as extractProcesses from a file" << endl;
+        failed++;
+    }
+    clear(l);
+    clear(expected);
+    expected = new ProcessList;
+    insertEvent(expected, 123, "a", "1");
+    insertEvent(expected, 456, "b", "2");
+    insertEvent(expected, 123, "c", "3");
+    stringstream input("123 a 1\n456 b 2\n123 c 3");
+    l = new ProcessList;
+    extractProcessesStream(l, input, 0);
+    if (sameProcessList(l, expected))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: stream of unknown size without final newline" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: stream of unknown size without final newline" << endl;
+        failed++;
+    }
+    clear(l);
+#ifndef _WIN32
+    const string fifoName = "testDataset.fifo";   //tube nommé : rien ne doit être lu avant le vrai lecteur
+    remove(fifoName.c_str());
+    mkfifo(fifoName.c_str(), 0600);
+    thread writer([&]() {
+        ofstream fifo(fifoName);
+        fifo << "123 a 1\n456 b 2\n123 c 3";
+    });
+    l = new ProcessList;
+    extractProcessesStream(l, fifoName);
+    writer.join();
+    remove(fifoName.c_str());
+    if (sameProcessList(l, expected))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: named pipe read from its first byte" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: named pipe read from its first byte" << endl;
+        failed++;
+    }
+    clear(l);
+#endif
+    clear(expected);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of extractProcessesStream() *********" << endl;
+}
+
+/*
+ * Timestamps
+ */
+void test_parseTimestamp()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of parseTimestamp() *********" << endl;
+    string texts[8] = {"Fri-Feb--3-19:44:59-2023", "Fri Feb  3 19:44:59 2023", "Wed-Feb-15-00:28:17-2023",
+                       "2023-02-03T19:44:59Z", "2023-02-03T20:44:59.250+01:00", "1675453499",
+                       "2023-02-03", "1970-01-01T00:00:00"};
+    int64_t expected[8] = {1675453499, 1675453499, 1676420897, 1675453499, 1675453499, 1675453499, 1675382400, 0};
+    for (int i=0; i<8; i++)
+    {
+        int64_t timestamp = NO_TIMESTAMP;
+        if (parseTimestamp(texts[i].data(), texts[i].size(), &timestamp) and timestamp == expected[i])
+        {
+            cout << GREEN << "PASS" << RESET << " \t: " << texts[i] << " = " << expected[i] << endl;
+            pass++;
+        }
+        else
+        {
+            cout << RED << "FAIL!" << RESET << " \t: " << texts[i] << " = " << expected[i] << endl;
+            failed++;
+        }
+    }
+    string invalid[5] = {"", "Fri-Fev--3-19:44:59-2023", "2023-13-03", "12:00", "Fri-Feb--3-19:44:59-2023x"};
+    for (int i=0; i<5; i++)
+    {
+        int64_t timestamp = NO_TIMESTAMP;
+        if (!parseTimestamp(invalid[i].data(), invalid[i].size(), &timestamp) and timestamp == NO_TIMESTAMP)
+        {
+            cout << GREEN << "PASS" << RESET << " \t: \"" << invalid[i] << "\" rejected" << endl;
+            pass++;
+        }
+        else
+        {
+            cout << RED << "FAIL!" << RESET << " \t: \"" << invalid[i] << "\" rejected" << endl;
+            failed++;
+        }
+    }
+    Process * p = new Process;
+    addActivity(p, "a", "not-a-date");
+    if (p->firstActivity->timestamp == NO_TIMESTAMP and p->firstActivity->time == "not-a-date")
+    {
+        cout << GREEN << "PASS" << RESET << " \t: unreadable time kept as text" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: unreadable time kept as text" << endl;
+        failed++;
+    }
+    clear(p);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of parseTimestamp() *********" << endl;
+}
+
+/*
+ * Process index
+ */
+void test_processIndex()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of the process index *********" << endl;
+    ProcessList * l = new ProcessList;
+    for (int i=0; i<100000; i++)  //ids tous inférieurs à 100000 * 1024, multiples de 1024
+    {
+        addProcess(l, i * 1024, "a", "1");
+    }
+    bool isCorrect = true;
+    for (int i=0; i<100000 and isCorrect; i++)
+    {
+        Process * p = processExists(l, i * 1024);
+        isCorrect = p != nullptr and p->id == i * 1024;
+    }
+    if (isCorrect)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: 100 000 processes found" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: 100 000 processes found" << endl;
+        failed++;
+    }
+    if (processExists(l, 1) == nullptr and processExists(l, -1024) == nullptr and processSummaryExists(l, 1023) == nullptr)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: unknown ids not found" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: unknown ids not found" << endl;
+        failed++;
+    }
+    Process * p = new Process;  //processus ajouté à la main, sans push_front
+    p->id = 7;
+    p->nextProcess = l->firstProcess;
+    l->firstProcess = p;
+    l->size++;
+    if (processExists(l, 7) == p)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: index rebuilt after a manual insertion" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: index rebuilt after a manual insertion" << endl;
+        failed++;
+    }
+    Process * replaced = l->firstProcess->nextProcess;    //processus remplacé à la main, même nombre de processus
+    Process * q = new Process;
+    q->id = 9;
+    q->nextProcess = replaced->nextProcess;
+    l->firstProcess->nextProcess = q;
+    l->version++;
+    if (processExists(l, 9) == q and processExists(l, replaced->id) == nullptr and processExists(l, 7) == p)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: index rebuilt after a manual replacement" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: index rebuilt after a manual replacement" << endl;
+        failed++;
+    }
+    clear(replaced);
+    delete replaced;
+    clear(l);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of the process index *********" << endl;
+}
+
+/*
+ * Columnar event store
+ */
+void test_eventStore()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of the event store *********" << endl;
+    ProcessList * l = generateProcessList();
+    EventStore store;
+    buildEventStore(l, &store);
+    if (nbCases(&store) == 3 and caseLength(&store, 0) == 3 and caseLength(&store, 1) == 1 and caseLength(&store, 2) == 2
+        and store.ids[0] == 123 and store.ids[2] == 789
+        and caseActivities(&store, 2)[1] == internActivity("b") and caseTimestamps(&store, 2)[1] == 6)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: cases <(a,1),(b,2),(c,3)>, <(b,4)>, <(a,5),(b,6)>" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: cases <(a,1),(b,2),(c,3)>, <(b,4)>, <(a,5),(b,6)>" << endl;
+        failed++;
+    }
+    if (averageProcessLength(&store) == averageProcessLength(l))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: same average length as the process list" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: same average length as the process list" << endl;
+        failed++;
+    }
+    Process * starts = new Process;
+    startActivities(&store, starts);
+    Process * ends = new Process;
+    endActivities(&store, ends);
+    if (starts->nbActivities == 2 and getActivityName(starts->firstActivity) == "a" and getActivityName(starts->firstActivity->nextActivity) == "b"
+        and ends->nbActivities == 2 and getActivityName(ends->firstActivity) == "b" and getActivityName(ends->firstActivity->nextActivity) == "c")
+    {
+        cout << GREEN << "PASS" << RESET << " \t: start <a, b> and end <b, c> activities" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: start <a, b> and end <b, c> activities" << endl;
+        failed++;
+    }
+    clear(starts);
+    clear(ends);
+    delete starts;
+    delete ends;
+    clear(l);
+    l = generateDuplicateProcessList();
+    addProcess(l, 999, "b", "7");
+    buildEventStore(l, &store);
+    ProcessList * v = new ProcessList;
+    variants(&store, v);
+    if (v->size == 3 and v->firstProcess->id == 789 and v->firstProcess->nextProcess->nextProcess->frequency == 2)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: 3 variants, first one found last (789), <b> followed by 2 cases" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: 3 variants, first one found last (789), <b> followed by 2 cases" << endl;
+        failed++;
+    }
+    clear(v);
+    clear(l);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of the event store *********" << endl;
+}
+
+/*
+ * Arena allocation
+ */
+void test_arena()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of enableArena() *********" << endl;
+    ofstream of(FILENAME_TEST);
+    for (int i=0; i<5000; i++)
+    {
+        of << (i * 7919) % 613 << ' ' << (char)('a' + i % 5) << ' ';
+        if (i % 10 == 0)
+            of << "date" << i << endl;  //date illisible, gardée en texte
+        else
+            of << i << endl;
+    }
+    of.close();
+    ProcessList * expected = new ProcessList;
+    extractProcesses(expected, FILENAME_TEST);
+    ProcessList * l = new ProcessList;
+    enableArena(l);
+    extractProcessesMapped(l, FILENAME_TEST);
+    if (l->arena != nullptr and l->arena->blocks.size() > 0 and l->firstProcess->arena == l->arena and sameProcessList(l, expected))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: same process list as extractProcesses, allocated in the arena" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: same process list as extractProcesses, allocated in the arena" << endl;
+        failed++;
+    }
+    clear(l);
+    l = new ProcessList;
+    enableArena(l);
+    extractProcessesParallel(l, FILENAME_TEST, 7);
+    bool isInArena = true;
+    for (Process * ptr = l->firstProcess; ptr != nullptr; ptr = ptr->nextProcess)
+        isInArena = isInArena and ptr->arena == l->arena;
+    if (isInArena and sameProcessList(l, expected))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: same process list with 7 threads, arenas of the threads merged" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: same process list with 7 threads, arenas of the threads merged" << endl;
+        failed++;
+    }
+    ProcessList * v = new ProcessList;
+    enableArena(v);
+    variants(l, v);
+    addSummary(v, v->firstProcess);
+    if (v->size > 0 and v->firstProcess->arena == v->arena and v->Summary != nullptr)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: variants and summary allocated in the arena" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: variants and summary allocated in the arena" << endl;
+        failed++;
+    }
+    clear(v);
+    clear(l);
+    clear(expected);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of enableArena() *********" << endl;
+}
+
+/*
+ * Binary snapshots
+ */
+void test_snapshot()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of saveSnapshot(), loadSnapshot() *********" << endl;
+    const string snapshotName = "testDataset.snapshot";
+    ofstream of(FILENAME_TEST);
+    for (int i=0; i<3000; i++)
+    {
+        of << (i * 7919) % 401 << ' ' << (char)('a' + i % 7) << ' ';
+        if (i % 13 == 0)
+            of << "date" << i << endl;  //date illisible, gardée en texte
+        else
+            of << 2 * i << endl;
+    }
+    of.close();
+    ProcessList * expected = new ProcessList;
+    extractProcessesMapped(expected, FILENAME_TEST);
+    ProcessList * l = new ProcessList;
+    if (saveSnapshot(expected, snapshotName, FILENAME_TEST) and loadSnapshot(l, snapshotName, FILENAME_TEST)
+        and sameProcessList(l, expected) and l->size == expected->size and processExists(l, expected->firstProcess->id) != nullptr)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: loaded process list identical to the extracted one" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: loaded process list identical to the extracted one" << endl;
+        failed++;
+    }
+    clear(l);
+    ProcessList * tracked = new ProcessList;
+    trackVariants(tracked);
+    extractProcessesMapped(tracked, FILENAME_TEST);
+    l = new ProcessList;
+    trackVariants(l);
+    ProcessList * expectedVariants = new ProcessList;
+    ProcessList * loadedVariants = new ProcessList;
+    bool isSameOrder = saveSnapshot(tracked, snapshotName, FILENAME_TEST) and loadSnapshot(l, snapshotName, FILENAME_TEST);
+    trieVariants(tracked, expectedVariants);
+    trieVariants(l, loadedVariants);
+    Process * v1 = expectedVariants->firstProcess;
+    Process * v2 = loadedVariants->firstProcess;
+    for (; isSameOrder and v1 != nullptr and v2 != nullptr; v1 = v1->nextProcess, v2 = v2->nextProcess)  //même ordre, même représentant
+        isSameOrder = v1->id == v2->id and v1->frequency == v2->frequency;
+    if (isSameOrder and v1 == nullptr and v2 == nullptr and expectedVariants->size > 1
+        and l->variantTrie->nodes.size() == tracked->variantTrie->nodes.size())
+    {
+        cout << GREEN << "PASS" << RESET << " \t: tracked variants in the order of the extraction" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: tracked variants in the order of the extraction" << endl;
+        failed++;
+    }
+    clear(expectedVariants);
+    clear(loadedVariants);
+    clear(tracked);
+    clear(l);
+    saveSnapshot(expected, snapshotName, FILENAME_TEST);    //snapshot sans arbre pour la suite
+    EventStore store;
+    EventStore expectedStore;
+    buildEventStore(expected, &expectedStore);
+    if (loadSnapshot(&store, snapshotName) and store.ids == expectedStore.ids and store.offsets == expectedStore.offsets
+        and store.codes == expectedStore.codes and store.timestamps == expectedStore.timestamps)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: loaded event store identical to buildEventStore" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: loaded event store identical to buildEventStore" << endl;
+        failed++;
+    }
+    ofstream append(FILENAME_TEST, ios::app);   //le journal change : snapshot périmé
+    append << "1 a 1" << endl;
+    append.close();
+    l = new ProcessList;
+    bool isOutdatedRefused = !loadSnapshot(l, snapshotName, FILENAME_TEST) and l->size == 0 and loadSnapshot(l, snapshotName);
+    clear(l);
+    if (isOutdatedRefused)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: snapshot refused once the log has changed" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: snapshot refused once the log has changed" << endl;
+        failed++;
+    }
+    l = new ProcessList;
+    bool isMissingSourceRefused = !saveSnapshot(expected, "missing.snapshot", "missing.txt") and !filesystem::exists("missing.snapshot")
+        and !loadSnapshot(l, snapshotName, "missing.txt") and l->size == 0;
+    clear(l);
+    if (isMissingSourceRefused)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: snapshot of a missing log neither saved nor loaded" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: snapshot of a missing log neither saved nor loaded" << endl;
+        failed++;
+    }
+    ifstream iFile(snapshotName, ios::binary);
+    string content((istreambuf_iterator<char>(iFile)), istreambuf_iterator<char>());
+    iFile.close();
+    SnapshotHeader header;
+    memcpy(&header, content.data(), sizeof(header));
+    auto padded = [](uint64_t aSize) { return aSize + (8 - aSize % 8) % 8; };
+    size_t textEventsStart = padded(sizeof(header)) + padded((header.nbNames + 1) * sizeof(uint64_t)) + padded(header.namesSize)
+        + padded(header.nbCases * sizeof(int)) + padded((header.nbCases + 1) * sizeof(uint64_t))
+        + padded(header.nbEvents * sizeof(int)) + padded(header.nbEvents * sizeof(int64_t));
+    string unordered = content;     //deux dates illisibles échangées
+    memcpy(&unordered[textEventsStart], &content[textEventsStart + sizeof(uint64_t)], sizeof(uint64_t));
+    memcpy(&unordered[textEventsStart + sizeof(uint64_t)], &content[textEventsStart], sizeof(uint64_t));
+    ofstream truncated(snapshotName, ios::binary | ios::trunc);
+    truncated.write(unordered.data(), unordered.size());
+    truncated.close();
+    l = new ProcessList;
+    bool isUnorderedRefused = header.nbTexts >= 2 and !loadSnapshot(l, snapshotName) and l->size == 0;
+    clear(l);
+    if (isUnorderedRefused)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: unreadable dates out of order refused" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: unreadable dates out of order refused" << endl;
+        failed++;
+    }
+    truncated.open(snapshotName, ios::binary | ios::trunc);
+    truncated.write(content.data(), content.size() / 2);
+    truncated.close();
+    l = new ProcessList;
+    bool isInvalidRefused = !loadSnapshot(l, snapshotName) and !loadSnapshot(l, FILENAME_TEST) and !loadSnapshot(l, "missing.snapshot") and l->size == 0;
+    clear(l);
+    if (isInvalidRefused)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: truncated snapshot, text log and missing file refused" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: truncated snapshot, text log and missing file refused" << endl;
+        failed++;
+    }
+    of.open(FILENAME_TEST);
+    of << "1 snapshotName0 1" << endl;
+    of.close();
+    l = new ProcessList;
+    extractProcessesMapped(l, FILENAME_TEST);
+    saveSnapshot(l, snapshotName);
+    clear(l);
+    iFile.open(snapshotName, ios::binary);
+    content.assign(istreambuf_iterator<char>(iFile), istreambuf_iterator<char>());
+    iFile.close();
+    content.replace(content.find("snapshotName0"), 13, "snapshotName1");     //nom absent du dictionnaire
+    memcpy(&header, content.data(), sizeof(header));
+    size_t codesStart = padded(sizeof(header)) + padded((header.nbNames + 1) * sizeof(uint64_t)) + padded(header.namesSize)
+        + padded(header.nbCases * sizeof(int)) + padded((header.nbCases + 1) * sizeof(uint64_t));
+    int nbCodes = nbActivityCodes();
+    bool isCodeChecked = true;
+    for (int code : {(int)header.nbNames, 0})    //code invalide puis valide
+    {
+        memcpy(&content[codesStart], &code, sizeof(code));
+        truncated.open(snapshotName, ios::binary | ios::trunc);
+        truncated.write(content.data(), content.size());
+        truncated.close();
+        l = new ProcessList;
+        isCodeChecked = code == 0 ? loadSnapshot(l, snapshotName) and nbActivityCodes() == nbCodes + 1
+                                     : !loadSnapshot(l, snapshotName) and nbActivityCodes() == nbCodes;
+        clear(l);
+        if (!isCodeChecked)
+            break;
+    }
+    if (isCodeChecked)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: invalid event code refused without adding the names of the snapshot" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: invalid event code refused without adding the names of the snapshot" << endl;
+        failed++;
+    }
+    remove(snapshotName.c_str());
+    clear(expected);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of saveSnapshot(), loadSnapshot() *********" << endl;
+}
+
+/*
+ * Variant trie
+ */
+void test_variantTrie()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of buildTrie(), casesWithPrefix(), trieVariants() *********" << endl;
+    ProcessList * l = generateProcessList();
+    VariantTrie trie;
+    buildTrie(l, &trie);
+    Process * prefix = new Process;
+    bool isCorrect = casesWithPrefix(&trie, prefix) == 3;
+    addActivity(prefix, "a", "0");
+    isCorrect = isCorrect and casesWithPrefix(&trie, prefix) == 2;
+    addActivity(prefix, "b", "0");
+    isCorrect = isCorrect and casesWithPrefix(&trie, prefix) == 2;
+    addActivity(prefix, "c", "0");
+    isCorrect = isCorrect and casesWithPrefix(&trie, prefix) == 1;
+    addActivity(prefix, "b", "0");
+    isCorrect = isCorrect and casesWithPrefix(&trie, prefix) == 0;
+    clear(prefix);
+    addActivity(prefix, "c", "0");
+    isCorrect = isCorrect and casesWithPrefix(&trie, prefix) == 0;
+    clear(prefix);
+    delete prefix;
+    if (isCorrect and trie.nodes.size() == 5 and trie.variants.size() == 3)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: <a,b,c>, <b>, <a,b> stored in 4 nodes, prefix counts <>=3 <a>=2 <a,b>=2 <a,b,c>=1" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: <a,b,c>, <b>, <a,b> stored in 4 nodes, prefix counts <>=3 <a>=2 <a,b>=2 <a,b,c>=1" << endl;
+        failed++;
+    }
+    clear(l);
+    writeTestLog(5000, 613);
+    l = new ProcessList;
+    extractProcessesMapped(l, FILENAME_TEST);
+    buildTrie(l, &trie);
+    ProcessList * expected = new ProcessList;
+    variants(l, expected);
+    ProcessList * v = new ProcessList;
+    trieVariants(&trie, v);
+    bool isSameFrequency = true;
+    for (Process * p1 = v->firstProcess, * p2 = expected->firstProcess; p1 != nullptr and p2 != nullptr; p1 = p1->nextProcess, p2 = p2->nextProcess)
+        isSameFrequency = isSameFrequency and p1->frequency == p2->frequency;
+    if (sameProcessList(v, expected) and isSameFrequency)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: same " << v->size << " variants and frequencies as variants()" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: same " << v->size << " variants and frequencies as variants()" << endl;
+        failed++;
+    }
+    clear(v);
+    clear(expected);
+    clear(l);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of buildTrie(), casesWithPrefix(), trieVariants() *********" << endl;
+}
+
+/*
+ * Parallel variants
+ */
+void test_variantsParallel()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of variantsParallel() *********" << endl;
+    writeTestLog(5000, 613);
+    ProcessList * l = new ProcessList;
+    extractProcessesMapped(l, FILENAME_TEST);
+    ProcessList * expected = new ProcessList;
+    variants(l, expected);
+    int nbThreads[4] = {1, 3, 8, 1000};   //1000 : plus de threads que de cas
+    for (int t=0; t<4; t++)
+    {
+        ProcessList * v = new ProcessList;
+        variantsParallel(l, v, nbThreads[t]);
+        bool isSameFrequency = true;
+        for (Process * p1 = v->firstProcess, * p2 = expected->firstProcess; p1 != nullptr and p2 != nullptr; p1 = p1->nextProcess, p2 = p2->nextProcess)
+            isSameFrequency = isSameFrequency and p1->frequency == p2->frequency;
+        if (sameProcessList(v, expected) and isSameFrequency)
+        {
+            cout << GREEN << "PASS" << RESET << " \t: same variants and frequencies as variants() with " << nbThreads[t] << " threads" << endl;
+            pass++;
+        }
+        else
+        {
+            cout << RED << "FAIL!" << RESET << " \t: same variants and frequencies as variants() with " << nbThreads[t] << " threads" << endl;
+            failed++;
+        }
+        clear(v);
+    }
+    clear(expected);
+    clear(l);
+    l = new ProcessList;
+    ProcessList * v = new ProcessList;
+    variantsParallel(l, v, 4);
+    if (v->size == 0 and v->firstProcess == nullptr)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: no variant in an empty list" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: no variant in an empty list" << endl;
+        failed++;
+    }
+    clear(v);
+    clear(l);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of variantsParallel() *********" << endl;
+}
+
+/*
+ * Variant tracking
+ */
+
+/**
+ * @brief Compare a tracked trie to the trie built afterwards by buildTrie:
+ * every node of the reference has the same counts in the tracked trie, and no other node is used
+ */
+bool sameTrieCounts(VariantTrie * aTracked, VariantTrie * aReference)
+{
+    int nbUsed = 0;
+    for (size_t i = 0; i < aTracked->nodes.size(); ++i)
+        nbUsed += aTracked->nodes[i].nbCases > 0;
+    if (nbUsed != (int)aReference->nodes.size())
+        return false;
+    vector<int> codes;
+    for (size_t i = 0; i < aReference->nodes.size(); ++i)
+    {
+        codes.clear();
+        for (int node = i; node > 0; node = aReference->nodes[node].parent)
+            codes.insert(codes.begin(), aReference->nodes[node].code);
+        int node = trieFind(aTracked, codes.data(), codes.size());
+        if (node == -1 or aTracked->nodes[node].nbCases != aReference->nodes[i].nbCases
+            or aTracked->nodes[node].frequency != aReference->nodes[i].frequency)
+            return false;
+    }
+    return true;
+}
+
+void test_trackVariants()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of trackVariants() *********" << endl;
+    ProcessList * l = new ProcessList;
+    trackVariants(l);
+    insertProcessActivity(l, 1, "a", "1");
+    insertProcessActivity(l, 2, "a", "2");
+    insertProcessActivity(l, 1, "b", "3");
+    insertProcessActivity(l, 3, "b", "4");
+    insertProcessActivity(l, 2, "b", "5");
+    VariantTrie reference;
+    buildTrie(l, &reference);
+    int ab[2] = {internActivity("a"), internActivity("b")};
+    int node = trieFind(l->variantTrie, ab, 2);
+    if (node != -1 and l->variantTrie->nodes[node].frequency == 2 and l->variantTrie->nodes[trieFind(l->variantTrie, ab, 1)].frequency == 0
+        and l->firstProcess->nextProcess->trieNode == node and sameTrieCounts(l->variantTrie, &reference))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: <a,b> followed by 2 cases, <a> by none once the cases have grown" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: <a,b> followed by 2 cases, <a> by none once the cases have grown" << endl;
+        failed++;
+    }
+    clear(l);
+    l = new ProcessList;
+    trackVariants(l);
+    insertProcessActivity(l, 1, "a", "1");
+    insertProcessActivity(l, 1, "b", "2");
+    insertProcessActivity(l, 2, "a", "3");
+    insertProcessActivity(l, 1, "c", "4");     //le cas 1 a quitté <a,b> : seul le cas 2 suit <a>
+    ProcessList * v = new ProcessList;
+    trieVariants(l, v);
+    ProcessList * fromTrie = new ProcessList;
+    trieVariants(l->variantTrie, fromTrie);
+    int a[1] = {internActivity("a")};
+    if (v->size == 2 and processExists(v, 2) != nullptr and processExists(v, 2)->nbActivities == 1
+        and processExists(v, 1) != nullptr and processExists(v, 1)->nbActivities == 3
+        and l->variantTrie->nodes[trieFind(l->variantTrie, a, 1)].firstCaseId == 2
+        and processExists(fromTrie, 2) != nullptr and processExists(fromTrie, 2)->nbActivities == 1)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: <a> represented by case 2 once case 1 has grown to <a,b,c>" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: <a> represented by case 2 once case 1 has grown to <a,b,c>" << endl;
+        failed++;
+    }
+    clear(v);
+    clear(fromTrie);
+    clear(l);
+    writeTestLog(5000, 613);
+    l = new ProcessList;
+    trackVariants(l);
+    extractProcesses(l, FILENAME_TEST);
+    buildTrie(l, &reference);
+    ProcessList * expected = new ProcessList;
+    variants(l, expected);
+    v = new ProcessList;
+    trieVariants(l, v);
+    bool isSameVariants = v->size == expected->size;
+    for (Process * ptr = v->firstProcess; ptr != nullptr; ptr = ptr->nextProcess)
+    {
+        Process * same = processExists(expected, ptr->id);   //même représentant que variants()
+        ProcessList found;
+        found.firstProcess = same;
+        found.size = same == nullptr ? 0 : 1;
+        if (same != nullptr)
+        {
+            Process * next = same->nextProcess;
+            same->nextProcess = nullptr;
+            isSameVariants = isSameVariants and processAlreadyExists(&found, ptr) and same->frequency == ptr->frequency;
+            same->nextProcess = next;
+        }
+        else
+            isSameVariants = false;
+    }
+    if (isSameVariants and sameTrieCounts(l->variantTrie, &reference))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: extractProcesses, " << v->size << " variants known at the end of the extraction, same ids as variants()" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: extractProcesses, " << v->size << " variants known at the end of the extraction, same ids as variants()" << endl;
+        failed++;
+    }
+    clear(v);
+    clear(expected);
+    const string snapshotName = "testDataset.snapshot";
+    saveSnapshot(l, snapshotName);
+    clear(l);
+    int nbThreads[3] = {1, 4, 16};
+    for (int t=0; t<3; t++)
+    {
+        l = new ProcessList;
+        enableArena(l);
+        trackVariants(l);
+        extractProcessesParallel(l, FILENAME_TEST, nbThreads[t]);
+        if (sameTrieCounts(l->variantTrie, &reference))
+        {
+            cout << GREEN << "PASS" << RESET << " \t: extractProcessesParallel with " << nbThreads[t] << " threads, merged tries" << endl;
+            pass++;
+        }
+        else
+        {
+            cout << RED << "FAIL!" << RESET << " \t: extractProcessesParallel with " << nbThreads[t] << " threads, merged tries" << endl;
+            failed++;
+        }
+        clear(l);
+    }
+    l = new ProcessList;
+    trackVariants(l);
+    if (loadSnapshot(l, snapshotName) and sameTrieCounts(l->variantTrie, &reference))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: loadSnapshot" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: loadSnapshot" << endl;
+        failed++;
+    }
+    clear(l);
+    remove(snapshotName.c_str());
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of trackVariants() *********" << endl;
+}
+
+/*
+ * Top variants
+ */
+void test_topVariants()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of topVariants() *********" << endl;
+    ProcessList * l = new ProcessList;
+    int ids[6] = {-5, 300, 2, 1000000, 7, 8};
+    string sequences[6] = {"ab", "b", "ab", "ab", "c", "b"};
+    for (int i=0; i<6; i++)
+        for (size_t j=0; j<sequences[i].size(); j++)
+            insertProcessActivity(l, ids[i], string(1, sequences[i][j]), to_string(i));
+    ProcessList * v = new ProcessList;
+    vector<TopVariant> top;
+    topVariants(l, 2, v, &top);
+    vector<int> abCases = top.size() == 2 ? topVariantCases(&top[0]) : vector<int>();
+    vector<int> bCases = top.size() == 2 ? topVariantCases(&top[1]) : vector<int>();
+    if (v->size == 2 and top.size() == 2 and top[0].variant == v->firstProcess and v->firstProcess->frequency == 3
+        and getActivityName(v->firstProcess->firstActivity) == "a" and top[0].coverage == 50
+        and abCases == vector<int>({-5, 2, 1000000}) and bCases == vector<int>({8, 300})
+        and getActivityName(top[1].variant->firstActivity) == "b" and top[1].variant->frequency == 2)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: top 2 of <a,b> x3, <b> x2, <c> x1: <a,b> 50% cases {-5,2,1000000}, <b> cases {8,300}" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: top 2 of <a,b> x3, <b> x2, <c> x1: <a,b> 50% cases {-5,2,1000000}, <b> cases {8,300}" << endl;
+        failed++;
+    }
+    clear(v);
+    clear(l);
+    writeTestLog(5000, 613);
+    for (int tracked=0; tracked<2; tracked++)
+    {
+        l = new ProcessList;
+        if (tracked == 1)
+            trackVariants(l);
+        extractProcessesMapped(l, FILENAME_TEST);
+        ProcessList * expected = new ProcessList;
+        variants(l, expected);
+        vector<int> frequencies;
+        for (Process * ptr = expected->firstProcess; ptr != nullptr; ptr = ptr->nextProcess)
+            frequencies.push_back(ptr->frequency);
+        sort(frequencies.rbegin(), frequencies.rend());
+        v = new ProcessList;
+        topVariants(l, 10, v, &top);
+        bool isCorrect = v->size == 10 and top.size() == 10;
+        double coverage = 0;
+        for (size_t i=0; i<top.size() and isCorrect; i++)
+        {
+            vector<int> cases = topVariantCases(&top[i]);
+            isCorrect = top[i].variant->frequency == frequencies[i] and (int)cases.size() == frequencies[i];
+            ProcessList alone;
+            alone.firstProcess = top[i].variant;
+            alone.size = 1;
+            for (size_t j=0; j<cases.size() and isCorrect; j++)
+                isCorrect = processAlreadyExists(&alone, processExists(l, cases[j]));
+            coverage += top[i].coverage;
+        }
+        clear(v);
+        v = new ProcessList;
+        topVariants(l, 1000000, v, &top);
+        double total = 0;
+        for (size_t i=0; i<top.size(); i++)
+            total += top[i].coverage;
+        if (isCorrect and coverage > 0 and (int)top.size() == expected->size and total > 99.999 and total < 100.001)
+        {
+            cout << GREEN << "PASS" << RESET << " \t: top 10 frequencies and cases" << (tracked == 1 ? " (tracked variants)" : "") << ", " << coverage << "% of the cases" << endl;
+            pass++;
+        }
+        else
+        {
+            cout << RED << "FAIL!" << RESET << " \t: top 10 frequencies and cases" << (tracked == 1 ? " (tracked variants)" : "") << ", " << coverage << "% of the cases" << endl;
+            failed++;
+        }
+        clear(v);
+        clear(expected);
+        clear(l);
+    }
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of topVariants() *********" << endl;
+}
+
+/*
+ * Activity histograms
+ */
+void test_activityHistograms()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of startEndHistograms() *********" << endl;
+    ProcessList * l = generateProcessList();    //<a,b,c>, <b>, <a,b> construits à la main
+    vector<int> starts;
+    vector<int> ends;
+    startEndHistograms(l, &starts, &ends);
+    int a = internActivity("a");
+    int b = internActivity("b");
+    int c = internActivity("c");
+    if (starts[a] == 2 and starts[b] == 1 and starts[c] == 0 and ends[a] == 0 and ends[b] == 2 and ends[c] == 1)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: starts a:2 b:1, ends b:2 c:1" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: starts a:2 b:1, ends b:2 c:1" << endl;
+        failed++;
+    }
+    clear(l);
+    writeTestLog(5000, 613);
+    l = new ProcessList;
+    extractProcessesMapped(l, FILENAME_TEST);
+    startEndHistograms(l, &starts, &ends);
+    vector<int> expectedStarts(starts.size(), 0);
+    vector<int> expectedEnds(ends.size(), 0);
+    for (Process * ptr = l->firstProcess; ptr != nullptr; ptr = ptr->nextProcess)
+    {
+        expectedStarts[activityCode(ptr->firstActivity)]++;
+        Activity * last = ptr->firstActivity;
+        while (last->nextActivity != nullptr)
+            last = last->nextActivity;
+        expectedEnds[activityCode(last)]++;
+    }
+    if (starts == expectedStarts and ends == expectedEnds)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: histograms of an extracted log" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: histograms of an extracted log" << endl;
+        failed++;
+    }
+    int nbThreads[3] = {1, 3, 1000};
+    for (int t=0; t<3; t++)
+    {
+        vector<int> parallelStarts;
+        vector<int> parallelEnds;
+        startEndHistogramsParallel(l, &parallelStarts, &parallelEnds, nbThreads[t]);
+        if (parallelStarts == expectedStarts and parallelEnds == expectedEnds)
+        {
+            cout << GREEN << "PASS" << RESET << " \t: same histograms with " << nbThreads[t] << " threads" << endl;
+            pass++;
+        }
+        else
+        {
+            cout << RED << "FAIL!" << RESET << " \t: same histograms with " << nbThreads[t] << " threads" << endl;
+            failed++;
+        }
+    }
+    clear(l);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of startEndHistograms() *********" << endl;
+}
+
+/*
+ * Directly-follows graph
+ */
+void test_buildDfg()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of buildDfg() *********" << endl;
+    ProcessList * l = generateProcessList();    //<a,b,c>, <b>, <a,b>
+    DirectlyFollowsGraph graph;
+    buildDfg(l, &graph, 1);
+    int a = internActivity("a");
+    int b = internActivity("b");
+    int c = internActivity("c");
+    int64_t nbEdges = 0;
+    for (size_t k=0; k<graph.edges.size(); k++)
+        nbEdges += graph.edges[k];
+    if (dfgEdge(&graph, a, b) == 2 and dfgEdge(&graph, b, c) == 1 and nbEdges == 3 and dfgEdge(&graph, b, a) == 0
+        and graph.starts[a] == 2 and graph.starts[b] == 1 and graph.ends[b] == 2 and graph.ends[c] == 1 and dfgEdge(&graph, -1, a) == 0)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: a->b 2, b->c 1, starts a:2 b:1, ends b:2 c:1" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: a->b 2, b->c 1, starts a:2 b:1, ends b:2 c:1" << endl;
+        failed++;
+    }
+    clear(l);
+    writeTestLog(5000, 613);
+    l = new ProcessList;
+    extractProcessesMapped(l, FILENAME_TEST);
+    DirectlyFollowsGraph expected;
+    expected.nbActivities = nbActivityCodes();
+    expected.edges.assign(expected.nbActivities * expected.nbActivities, 0);
+    expected.starts.assign(expected.nbActivities, 0);
+    expected.ends.assign(expected.nbActivities, 0);
+    for (Process * ptr = l->firstProcess; ptr != nullptr; ptr = ptr->nextProcess)
+    {
+        expected.starts[activityCode(ptr->firstActivity)]++;
+        Activity * activityPtr = ptr->firstActivity;
+        for (; activityPtr->nextActivity != nullptr; activityPtr = activityPtr->nextActivity)
+            expected.edges[activityCode(activityPtr) * expected.nbActivities + activityCode(activityPtr->nextActivity)]++;
+        expected.ends[activityCode(activityPtr)]++;
+    }
+    EventStore store;
+    buildEventStore(l, &store);
+    int nbThreads[4] = {1, 2, 7, 10000};
+    for (int t=0; t<4; t++)
+    {
+        buildDfg(&store, &graph, nbThreads[t]);
+        if (graph.edges == expected.edges and graph.starts == expected.starts and graph.ends == expected.ends)
+        {
+            cout << GREEN << "PASS" << RESET << " \t: same graph as walking the activities, " << nbThreads[t] << " threads" << endl;
+            pass++;
+        }
+        else
+        {
+            cout << RED << "FAIL!" << RESET << " \t: same graph as walking the activities, " << nbThreads[t] << " threads" << endl;
+            failed++;
+        }
+    }
+    clear(l);
+    l = new ProcessList;
+    buildDfg(l, &graph, 4);
+    nbEdges = 0;
+    for (size_t k=0; k<graph.edges.size(); k++)
+        nbEdges += graph.edges[k] + graph.starts[k % graph.nbActivities];
+    if (nbEdges == 0 and graph.nbActivities == nbActivityCodes())
+    {
+        cout << GREEN << "PASS" << RESET << " \t: empty graph of an empty list" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: empty graph of an empty list" << endl;
+        failed++;
+    }
+    clear(l);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of buildDfg() *********" << endl;
+}
+
+void test_durationStatistics()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of durationStatistics() *********" << endl;
+    ofstream of(FILENAME_TEST);
+    of << "1 a 10" << endl << "2 a 5" << endl << "1 b 15" << endl << "3 a 7" << endl << "2 b 5" << endl << "1 c 30" << endl;
+    of.close();
+    ProcessList * l = new ProcessList;
+    extractProcessesMapped(l, FILENAME_TEST);
+    DurationStatistics statistics;
+    durationStatistics(l, &statistics, 1);
+    const QuantileSketch * durations = &statistics.caseDurations;
+    if (durations->count == 3 and durations->min == 0 and durations->max == 20 and sketchMean(durations) == 20.0 / 3
+        and sketchQuantile(durations, 0.5) == 0 and sketchQuantile(durations, 0.9) == 20)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: case durations 20, 0, 0" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: case durations 20, 0, 0" << endl;
+        failed++;
+    }
+    const QuantileSketch * ab = transitionWaitingTimes(&statistics, internActivity("a"), internActivity("b"));
+    const QuantileSketch * bc = transitionWaitingTimes(&statistics, internActivity("b"), internActivity("c"));
+    if (statistics.waitingTimes.count == 3 and sketchQuantile(&statistics.waitingTimes, 0.5) == 5 and statistics.waitingTimes.max == 15
+        and ab != nullptr and ab->count == 2 and ab->sum == 5 and bc != nullptr and bc->count == 1 and bc->min == 15
+        and transitionWaitingTimes(&statistics, internActivity("b"), internActivity("a")) == nullptr)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: waiting times a->b 5, 0 and b->c 15" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: waiting times a->b 5, 0 and b->c 15" << endl;
+        failed++;
+    }
+    clear(l);
+    of.open(FILENAME_TEST);
+    of << "1 a 100" << endl << "1 b undated" << endl << "1 c 130" << endl << "1 d 140" << endl;
+    of.close();
+    l = new ProcessList;
+    extractProcessesMapped(l, FILENAME_TEST);
+    durationStatistics(l, &statistics, 1);
+    const QuantileSketch * cd = transitionWaitingTimes(&statistics, internActivity("c"), internActivity("d"));
+    if (statistics.caseDurations.count == 1 and statistics.caseDurations.max == 40 and statistics.waitingTimes.count == 1
+        and cd != nullptr and cd->count == 1 and cd->min == 10
+        and transitionWaitingTimes(&statistics, internActivity("a"), internActivity("c")) == nullptr
+        and transitionWaitingTimes(&statistics, internActivity("b"), internActivity("c")) == nullptr)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: an undated activity breaks the chain of waiting times" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: an undated activity breaks the chain of waiting times" << endl;
+        failed++;
+    }
+    clear(l);
+    const int nbValues = 100000;
+    QuantileSketch sketch;
+    QuantileSketch parts[4];
+    for (int i=0; i<nbValues; i++)
+    {
+        double value = (int64_t)i * 7919 % nbValues;    //une permutation de 0..nbValues-1
+        sketchAdd(&sketch, value);
+        sketchAdd(&parts[i % 4], value);
+    }
+    QuantileSketch merged;
+    for (int i=0; i<4; i++)
+        sketchMerge(&merged, &parts[i]);
+    size_t nbKept = 0;
+    for (size_t h=0; h<merged.levels.size(); h++)
+        nbKept += merged.levels[h].size();
+    bool accurate = true;
+    for (int q=1; q<100; q++)
+    {
+        accurate = accurate and abs(sketchQuantile(&sketch, q / 100.0) - q * nbValues / 100) < nbValues * 0.02
+                   and abs(sketchQuantile(&merged, q / 100.0) - q * nbValues / 100) < nbValues * 0.02;
+    }
+    if (accurate and merged.count == nbValues and merged.min == 0 and merged.max == nbValues - 1
+        and sketchMean(&merged) == sketchMean(&sketch) and nbKept < 1000)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: quantiles of 100000 values within 2%, merged or not, " << nbKept << " values kept" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: quantiles of 100000 values within 2%, merged or not, " << nbKept << " values kept" << endl;
+        failed++;
+    }
+    writeTestLog(5000, 613);
+    l = new ProcessList;
+    extractProcessesMapped(l, FILENAME_TEST);
+    DurationStatistics sequential;
+    durationStatistics(l, &sequential, 1);
+    int nbThreads[3] = {3, 7, 10000};
+    for (int t=0; t<3; t++)
+    {
+        durationStatistics(l, &statistics, nbThreads[t]);
+        if (statistics.caseDurations.count == 613 and statistics.caseDurations.sum == sequential.caseDurations.sum
+            and statistics.waitingTimes.count == 5000 - 613 and statistics.waitingTimes.sum == sequential.waitingTimes.sum
+            and statistics.waitingTimes.min == sequential.waitingTimes.min and statistics.waitingTimes.max == sequential.waitingTimes.max
+            and abs(sketchQuantile(&statistics.waitingTimes, 0.5) - sketchQuantile(&sequential.waitingTimes, 0.5)) <= 0.02 * sequential.waitingTimes.max
+            and statistics.transitionWaits.size() == sequential.transitionWaits.size())
+        {
+            cout << GREEN << "PASS" << RESET << " \t: same statistics with " << nbThreads[t] << " threads" << endl;
+            pass++;
+        }
+        else
+        {
+            cout << RED << "FAIL!" << RESET << " \t: same statistics with " << nbThreads[t] << " threads" << endl;
+            failed++;
+        }
+    }
+    clear(l);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of durationStatistics() *********" << endl;
+}
+
+/**
+ * @brief Compare the state of a followed list to an extraction of the whole file:
+ * same list, same tracked variants and same histograms
+ */
+bool sameFollowedState(ProcessList * aList, const LogFollower * aFollower, string aFileName)
+{
+    ProcessList * expected = new ProcessList;
+    extractProcessesMapped(expected, aFileName);
+    VariantTrie trie;
+    buildTrie(expected, &trie);
+    vector<int> starts, ends;
+    startEndHistograms(expected, &starts, &ends);
+    vector<int> followedStarts = aFollower->starts;
+    vector<int> followedEnds = aFollower->ends;
+    followedStarts.resize(starts.size(), 0);
+    followedEnds.resize(ends.size(), 0);
+    bool isSame = sameProcessList(aList, expected) and sameTrieCounts(aList->variantTrie, &trie)
+                  and followedStarts == starts and followedEnds == ends;
+    clear(expected);
+    return isSame;
+}
+
+void test_followLog()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of followOpen(), followPoll(), followWait(), followLog() *********" << endl;
+    ofstream of(FILENAME_TEST, ios::binary);
+    of << "1 a 1" << endl << "2 a 2" << endl << "1 b";
+    of.close();
+    ProcessList * l = new ProcessList;
+    LogFollower follower;
+    bool isOpen = followOpen(&follower, l, FILENAME_TEST);
+    int nbAdded = followPoll(&follower, l);
+    if (isOpen and nbAdded == 2 and l->size == 2 and follower.pending == "1 b" and follower.starts[internActivity("a")] == 2
+        and follower.ends[internActivity("a")] == 2)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: first batch of 2 events, incomplete line kept" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: first batch of 2 events, incomplete line kept" << endl;
+        failed++;
+    }
+    if (!followWait(&follower, 50) and followPoll(&follower, l) == 0)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: no change, the wait times out and the batch is empty" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: no change, the wait times out and the batch is empty" << endl;
+        failed++;
+    }
+    of.open(FILENAME_TEST, ios::binary | ios::app);
+    of << " 3" << endl;
+    writeTestLines(of, 0, 5000, 613, false);
+    of.close();
+    bool isChanged = followWait(&follower, 1000);
+    nbAdded = followPoll(&follower, l);
+    if (isChanged and nbAdded == 5001 and follower.pending.empty() and sameFollowedState(l, &follower, FILENAME_TEST))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: appended lines, same list, variants and histograms as the whole file" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: appended lines, same list, variants and histograms as the whole file" << endl;
+        failed++;
+    }
+    followClose(&follower);
+    clear(l);
+    l = new ProcessList;
+    followOpen(&follower, l, FILENAME_TEST);
+    followPoll(&follower, l);
+    of.open(FILENAME_TEST, ios::binary | ios::trunc);
+    of << "7 c 1" << endl;
+    of.close();
+    nbAdded = followPoll(&follower, l);
+    if (nbAdded == 1 and processExists(l, 7) != nullptr and follower.nbEvents == 5004 and follower.starts[internActivity("c")] >= 1)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: truncated file read again from the beginning" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: truncated file read again from the beginning" << endl;
+        failed++;
+    }
+    of.open(FILENAME_TEST + ".new", ios::binary);
+    of << "1009 e 1" << endl << "1009 f 2" << endl;
+    of.close();
+    filesystem::rename(FILENAME_TEST + ".new", FILENAME_TEST);     //plus long que les octets déjà lus
+    isChanged = followWait(&follower, 1000);
+    nbAdded = followPoll(&follower, l);
+    of.open(FILENAME_TEST, ios::binary | ios::app);
+    of << "1009 g 3" << endl;
+    of.close();
+    if (isChanged and nbAdded == 2 and processExists(l, 1009) != nullptr and processExists(l, 1009)->nbActivities == 2
+        and followWait(&follower, 1000) and followPoll(&follower, l) == 1 and processExists(l, 1009)->nbActivities == 3)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: file replaced by rename read from the beginning, new file watched" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: file replaced by rename read from the beginning, new file watched" << endl;
+        failed++;
+    }
+    filesystem::rename(FILENAME_TEST, FILENAME_TEST + ".1");
+    isChanged = followWait(&follower, 1000);
+    bool isMissing = followPoll(&follower, l) < 0;
+    of.open(FILENAME_TEST, ios::binary);
+    of << "1007 c 1" << endl;
+    of.close();
+    bool isCreated = followWait(&follower, 1000);
+    nbAdded = followPoll(&follower, l);
+    of.open(FILENAME_TEST, ios::binary | ios::app);
+    of << "1009 h 4" << endl;
+    of.close();
+    if (isChanged and isMissing and isCreated and nbAdded == 1 and followWait(&follower, 1000) and followPoll(&follower, l) == 1
+        and processExists(l, 1009)->nbActivities == 4 and processExists(l, 1007) != nullptr)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: rotated file (moved away then created again) followed under its name" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: rotated file (moved away then created again) followed under its name" << endl;
+        failed++;
+    }
+    filesystem::remove(FILENAME_TEST + ".1");
+    of.open(FILENAME_TEST, ios::binary | ios::trunc);
+    of << "7 c 1" << endl;
+    of.close();
+    followClose(&follower);
+    clear(l);
+    l = new ProcessList;
+    int nbBatches = 0;
+    followLog(l, FILENAME_TEST, [&](ProcessList * aList, const LogFollower * aFollower) {
+        nbBatches++;
+        if (nbBatches == 1)
+        {
+            ofstream append(FILENAME_TEST, ios::binary | ios::app);
+            append << "7 d 2" << endl << "8 a 3" << endl;
+        }
+        return nbBatches < 2 and aFollower->nbEvents == aList->size;
+    }, 1000);
+    if (nbBatches == 2 and l->size == 2 and processExists(l, 7)->nbActivities == 2)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: followLog, state queried after each of the 2 batches" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: followLog, state queried after each of the 2 batches" << endl;
+        failed++;
+    }
+    clear(l);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of followOpen(), followPoll(), followWait(), followLog() *********" << endl;
+}
+
+void test_streamCases()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of streamOpen(), streamEvent(), streamFlush(), streamFile() *********" << endl;
+    CaseStream stream;
+    streamOpen(&stream, {"e"}, 0);
+    streamEvent(&stream, 1, "a", "1");
+    streamEvent(&stream, 2, "a", "2");
+    streamEvent(&stream, 1, "e", "3");
+    bool isFinished = stream.nbEnded == 1 and stream.openCases.size() == 1 and stream.caseLengths.count == 1;
+    streamEvent(&stream, 1, "b", "4");
+    int a = internActivity("a");
+    int e = internActivity("e");
+    if (isFinished and stream.openCases.size() == 2 and stream.openCases[1].process->nbActivities == 1
+        and dfgEdge(&stream.dfg, a, e) == 1 and stream.dfg.starts[a] == 1 and stream.dfg.ends[e] == 1)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: case <a,e> finished by e, the same id starts a new case" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: case <a,e> finished by e, the same id starts a new case" << endl;
+        failed++;
+    }
+    streamClose(&stream);
+    streamOpen(&stream, {}, 5);
+    streamEvent(&stream, 1, "a", "1");
+    streamEvent(&stream, 2, "a", "2");
+    streamEvent(&stream, 2, "b", "6");
+    isFinished = stream.nbTimedOut == 0;
+    streamEvent(&stream, 2, "c", "10");     //1 + 5 < 10 : le cas 1 a expiré, pas le 2 (6 + 5 >= 10)
+    streamEvent(&stream, 1, "c", "11");
+    if (isFinished and stream.nbTimedOut == 1 and stream.caseLengths.count == 1 and stream.openCases.size() == 2
+        and stream.openCases[1].process->nbActivities == 1 and stream.openCases[2].process->nbActivities == 3
+        and stream.expiries.size() == 2)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: inactive case finished after the timeout, active case kept" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: inactive case finished after the timeout, active case kept" << endl;
+        failed++;
+    }
+    streamFlush(&stream);
+    if (stream.openCases.empty() and stream.nbFinished == 3 and stream.caseLengths.sum == 5 and stream.nbEvents == 5)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: flush finishes the 2 open cases" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: flush finishes the 2 open cases" << endl;
+        failed++;
+    }
+    streamOpen(&stream, {}, 1000000);
+    for (int i=0; i<5000; i++)
+        streamEvent(&stream, i % 613, "a", to_string(i));
+    if (stream.nbTimedOut == 0 and stream.openCases.size() == 613 and stream.expiries.size() == 613)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: 5000 events of 613 open cases, one expiry each" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: 5000 events of 613 open cases, one expiry each" << endl;
+        failed++;
+    }
+    streamOpen(&stream, {}, 1000);     //chaque cas revient tous les 613 s
+    for (int i=0; i<5000; i++)
+        streamEvent(&stream, i % 613, "a", to_string(i));
+    if (stream.nbTimedOut == 0 and stream.openCases.size() == 613 and stream.expiries.size() == 613)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: expiries of active cases moved to their last event, not duplicated" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: expiries of active cases moved to their last event, not duplicated" << endl;
+        failed++;
+    }
+    writeTestLog(5000, 613);
+    ProcessList * l = new ProcessList;
+    extractProcessesMapped(l, FILENAME_TEST);
+    VariantTrie trie;
+    buildTrie(l, &trie);
+    DirectlyFollowsGraph graph;
+    buildDfg(l, &graph, 1);
+    streamOpen(&stream, {}, 0);
+    streamFile(&stream, FILENAME_TEST);
+    if (sameTrieCounts(&stream.variants, &trie) and stream.dfg.edges == graph.edges and stream.nbFinished == l->size
+        and stream.caseLengths.sum == 5000 and stream.maxOpenCases == l->size)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: no end activity, same variants and graph as the whole list" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: no end activity, same variants and graph as the whole list" << endl;
+        failed++;
+    }
+    streamOpen(&stream, {"d"}, 300);
+    streamFile(&stream, FILENAME_TEST);
+    if (stream.nbEnded > 0 and stream.nbTimedOut > 0 and stream.nbFinished > l->size and stream.maxOpenCases < l->size
+        and stream.caseLengths.sum == 5000 and stream.openCases.empty())
+    {
+        cout << GREEN << "PASS" << RESET << " \t: end activity d and timeout 300, " << stream.maxOpenCases << " cases open at most" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: end activity d and timeout 300, " << stream.maxOpenCases << " cases open at most" << endl;
+        failed++;
+    }
+    streamClose(&stream);
+    clear(l);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of streamOpen(), streamEvent(), streamFlush(), streamFile() *********" << endl;
+}
+
+void test_extractProcessesSegments()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of logSegments(), extractProcesses() with several files *********" << endl;
+    string directory = "testSegments";
+    filesystem::remove_all(directory);
+    filesystem::create_directory(directory);
+    string names[3] = {"log.1", "log.2", "log.10"};
+    writeTestLog(5000, 613);
+    ofstream segments[3];
+    for (int k=0; k<3; k++)
+    {
+        segments[k].open(directory + "/" + names[k]);
+        writeTestLines(segments[k], k * 5000 / 3, (k + 1) * 5000 / 3, 613, false);
+        segments[k].close();
+    }
+    ofstream of(directory + "/.log.0");
+    of << "1 z 1" << endl;
+    of.close();
+    filesystem::file_time_type now = filesystem::file_time_type::clock::now();
+    for (int k=0; k<3; k++)
+        filesystem::last_write_time(directory + "/" + names[k], now - chrono::hours(3 - k));
+    vector<string> found = logSegments(directory, SEGMENTS_BY_NAME);
+    if (found.size() == 3 and filesystem::path(found[0]).filename() == "log.1" and filesystem::path(found[1]).filename() == "log.2"
+        and filesystem::path(found[2]).filename() == "log.10")
+    {
+        cout << GREEN << "PASS" << RESET << " \t: segments log.1, log.2, log.10 in natural order, hidden file ignored" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: segments log.1, log.2, log.10 in natural order, hidden file ignored" << endl;
+        failed++;
+    }
+    ProcessList * expected = new ProcessList;
+    extractProcessesMapped(expected, FILENAME_TEST);
+    int nbThreads[3] = {1, 2, 8};
+    for (int t=0; t<3; t++)
+    {
+        ProcessList * l = new ProcessList;
+        extractProcesses(l, found, nbThreads[t]);
+        if (sameProcessList(l, expected))
+        {
+            cout << GREEN << "PASS" << RESET << " \t: same list as the concatenated file, " << nbThreads[t] << " threads" << endl;
+            pass++;
+        }
+        else
+        {
+            cout << RED << "FAIL!" << RESET << " \t: same list as the concatenated file, " << nbThreads[t] << " threads" << endl;
+            failed++;
+        }
+        clear(l);
+    }
+    ProcessList * l = new ProcessList;
+    enableArena(l);
+    trackVariants(l);
+    extractProcesses(l, directory);
+    VariantTrie trie;
+    buildTrie(expected, &trie);
+    if (sameProcessList(l, expected) and sameTrieCounts(l->variantTrie, &trie))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: directory given to extractProcesses, arena and tracked variants" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: directory given to extractProcesses, arena and tracked variants" << endl;
+        failed++;
+    }
+    clear(l);
+    filesystem::remove_all(directory);
+    filesystem::create_directory(directory);
+    string rotated[3] = {"app.log.2", "app.log.1", "app.log"};     //logrotate : app.log est le plus récent
+    for (int k=0; k<3; k++)
+    {
+        segments[k].open(directory + "/" + rotated[k]);
+        writeTestLines(segments[k], k * 5000 / 3, (k + 1) * 5000 / 3, 613, false);
+        segments[k].close();
+        filesystem::last_write_time(directory + "/" + rotated[k], now - chrono::hours(3 - k));
+    }
+    found = logSegments(directory);
+    vector<string> byRotation = logSegments(directory, SEGMENTS_ROTATED);
+    bool isLogOrder = found.size() == 3 and byRotation == found;
+    for (int k=0; k<3 and isLogOrder; k++)
+        isLogOrder = filesystem::path(found[k]).filename() == rotated[k];
+    l = new ProcessList;
+    extractProcesses(l, directory);
+    if (isLogOrder and sameProcessList(l, expected))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: rotated app.log, app.log.1, app.log.2 read oldest first, by time and by rotation" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: rotated app.log, app.log.1, app.log.2 read oldest first, by time and by rotation" << endl;
+        failed++;
+    }
+    clear(l);
+    clear(expected);
+    filesystem::remove_all(directory);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of logSegments(), extractProcesses() with several files *********" << endl;
+}
+
+void test_extractProcessesGzip()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of isGzipFile(), extractProcessesGzip() *********" << endl;
+    string gzipName = "testDataset.txt.gz";
+    ofstream of(FILENAME_TEST);
+    for (int part=0; part<2; part++)    //un second membre ajouté à la suite du premier
+    {
+        ostringstream lines;
+        writeTestLines(lines, part * 100000, (part + 1) * 100000, 20011, false);
+        string text = lines.str();
+        of << text;
+        gzFile compressed = gzopen(gzipName.c_str(), part == 0 ? "wb" : "ab");
+        gzwrite(compressed, text.data(), text.size());
+        gzclose(compressed);
+    }
+    of.close();
+    if (isGzipFile(gzipName) and !isGzipFile(FILENAME_TEST) and !isGzipFile("notAFile.gz"))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: gzip magic number detected" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: gzip magic number detected" << endl;
+        failed++;
+    }
+    ProcessList * expected = new ProcessList;
+    extractProcessesMapped(expected, FILENAME_TEST);
+    ProcessList * l = new ProcessList;
+    extractProcessesGzip(l, gzipName);
+    if (sameProcessList(l, expected))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: same list as the decompressed file (2 members, 200000 lines)" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: same list as the decompressed file (2 members, 200000 lines)" << endl;
+        failed++;
+    }
+    clear(l);
+    l = new ProcessList;
+    enableArena(l);
+    extractProcesses(l, gzipName);
+    if (sameProcessList(l, expected))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: gzip file given to extractProcesses" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: gzip file given to extractProcesses" << endl;
+        failed++;
+    }
+    clear(l);
+    clear(expected);
+    filesystem::resize_file(gzipName, filesystem::file_size(gzipName) / 3);
+    l = new ProcessList;
+    extractProcessesGzip(l, gzipName);
+    if (l->size > 0 and l->size <= 20011)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: truncated gzip file, the beginning is read" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: truncated gzip file, the beginning is read" << endl;
+        failed++;
+    }
+    clear(l);
+    filesystem::remove(gzipName);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of isGzipFile(), extractProcessesGzip() *********" << endl;
+}
+
+void test_extractProcessesPipeline()
+{
+    int pass = 0;
+    int failed = 0;
+    cout << "********* Start testing of extractProcessesPipeline() *********" << endl;
+    ofstream of(FILENAME_TEST, ios::binary);
+    writeTestLines(of, 0, 200000, 20011, true);
+    of << "42 z 7";
+    of.close();
+    ProcessList * expected = new ProcessList;
+    extractProcessesMapped(expected, FILENAME_TEST);
+    ProcessList * l = new ProcessList;
+    extractProcessesPipeline(l, FILENAME_TEST);
+    if (sameProcessList(l, expected) and processExists(l, 42)->lastActivity->timestamp == 7)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: same list as extractProcessesMapped, 200000 lines" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: same list as extractProcessesMapped, 200000 lines" << endl;
+        failed++;
+    }
+    clear(l);
+    l = new ProcessList;
+    enableArena(l);
+    trackVariants(l);
+    extractProcessesPipeline(l, FILENAME_TEST);
+    VariantTrie trie;
+    buildTrie(expected, &trie);
+    if (sameProcessList(l, expected) and sameTrieCounts(l->variantTrie, &trie))
+    {
+        cout << GREEN << "PASS" << RESET << " \t: same list and variants with an arena and tracked variants" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: same list and variants with an arena and tracked variants" << endl;
+        failed++;
+    }
+    clear(l);
+    clear(expected);
+    of.open(FILENAME_TEST, ios::binary | ios::trunc);
+    of.close();
+    l = new ProcessList;
+    extractProcessesPipeline(l, FILENAME_TEST);
+    if (l->size == 0 and l->firstProcess == nullptr)
+    {
+        cout << GREEN << "PASS" << RESET << " \t: empty file" << endl;
+        pass++;
+    }
+    else
+    {
+        cout << RED << "FAIL!" << RESET << " \t: empty file" << endl;
+        failed++;
+    }
+    clear(l);
+    cout << BLUE << "Totals: " << pass << " passed, " << failed << " failed" << RESET << endl;
+    cout << "********* Finished testing of extractProcessesPipeline() *********" << endl;
+}
@@ -120,4 +120,230 @@ void test_insertActivity();
 void test_processAlreadyExists();
 
 
+/*
+ * Memory-mapped ingestion
+ */
+/**
+ * @brief unit test for extractProcessesMapped
+ * Test if the mapped, single pass extraction builds the same process list
+ * as extractProcesses, including on CRLF files and files without a final newline
+ */
+void test_extractProcessesMapped();
+
+
+/*
+ * Parallel ingestion
+ */
+/**
+ * @brief unit test for extractProcessesParallel
+ * Test if the multi-threaded extraction builds the same process list
+ * as extractProcesses whatever the number of threads
+ */
+void test_extractProcessesParallel();
+
+
+/*
+ * Vectorized scanning
+ */
+/**
+ * @brief unit test for countNewlines, findSeparator and parseId
+ * Test if every scanner level supported by the processor gives
+ * the same results as the scalar version
+ */
+void test_vectorizedScanning();
+
+
+/*
+ * Streaming ingestion
+ */
+/**
+ * @brief unit test for extractProcessesStream
+ * Test if the single pass stream extraction builds the same process list
+ * as extractProcesses, for a file and for a stream of unknown size
+ */
+void test_extractProcessesStream();
+
+
+/*
+ * Timestamps
+ */
+/**
+ * @brief unit test for parseTimestamp
+ * Test the supported formats against known epoch values, and that
+ * invalid texts are rejected
+ */
+void test_parseTimestamp();
+
+
+/*
+ * Process index
+ */
+/**
+ * @brief unit test for the process index used by processExists
+ * Test lookups on a large list with badly distributed ids,
+ * and the rebuild of the index after a manual modification of the list
+ */
+void test_processIndex();
+
+
+/*
+ * Columnar event store
+ */
+/**
+ * @brief unit test for the event store
+ * Test the layout of a store built from a process list, and the
+ * analytics functions on a store against the process list versions
+ */
+void test_eventStore();
+
+
+/*
+ * Arena allocation
+ */
+/**
+ * @brief unit test for enableArena and the arena allocation
+ * Test that lists allocated in an arena are identical to lists allocated
+ * with new, with the sequential and the parallel extraction
+ */
+void test_arena();
+
+
+/*
+ * Binary snapshots
+ */
+/**
+ * @brief unit test for saveSnapshot and loadSnapshot
+ * Test that a saved then loaded process list is identical to the extracted one,
+ * and that invalid or outdated snapshots are refused
+ */
+void test_snapshot();
+
+
+/*
+ * Variant trie
+ */
+/**
+ * @brief unit test for buildTrie
+ * Test the prefix counts of a trie and that its variants are the ones found by variants()
+ */
+void test_variantTrie();
+
+
+/*
+ * Parallel variants
+ */
+/**
+ * @brief unit test for variantsParallel
+ * Test that the variants found with several threads are the ones found by variants()
+ */
+void test_variantsParallel();
+
+
+/*
+ * Variant tracking
+ */
+/**
+ * @brief unit test for trackVariants
+ * Test that the trie updated during the extraction (sequential, parallel, snapshot)
+ * has the prefix counts and the variants of a trie built afterwards
+ */
+void test_trackVariants();
+
+
+/*
+ * Top variants
+ */
+/**
+ * @brief unit test for topVariants
+ * Test the selection of the most frequent variants, their coverage and the decoding of their cases
+ */
+void test_topVariants();
+
+
+/*
+ * Activity histograms
+ */
+/**
+ * @brief unit test for the start and end activity histograms
+ * Test the start and end histograms of hand built and extracted lists, sequential and parallel
+ */
+void test_activityHistograms();
+
+
+/*
+ * Directly-follows graph
+ */
+/**
+ * @brief unit test for buildDfg
+ * Test the transition, start and end counts against a walk of the activities, with several threads
+ */
+void test_buildDfg();
+
+
+/*
+ * Duration statistics
+ */
+/**
+ * @brief unit test for durationStatistics and the quantile sketch
+ * Test the exact statistics of a small log, the rank error of the quantile sketch and of merged sketches,
+ * and the same statistics with several threads
+ */
+void test_durationStatistics();
+
+
+/*
+ * Live tail mode
+ */
+/**
+ * @brief unit test for followLog
+ * Test batches of appended lines (incomplete last line, truncated file, timeout)
+ * against an extraction of the whole file: list, variants and histograms
+ */
+void test_followLog();
+
+
+/*
+ * Memory-bounded streaming
+ */
+/**
+ * @brief unit test for the memory-bounded case stream
+ * Test the cases finished by an end activity and by the timeout,
+ * and the aggregates of a whole log against buildTrie and buildDfg
+ */
+void test_streamCases();
+
+
+/*
+ * Multi-file ingestion
+ */
+/**
+ * @brief unit test for extractProcesses over several files
+ * Test the natural order of the segments of a directory and the list extracted from the segments
+ * against the list of the concatenated file, with several threads
+ */
+void test_extractProcessesSegments();
+
+
+/*
+ * Compressed ingestion
+ */
+/**
+ * @brief unit test for isGzipFile and extractProcessesGzip
+ * Test the list extracted from a gzip file of two members (lines split between blocks)
+ * against the list of the decompressed file, and a truncated gzip file
+ */
+void test_extractProcessesGzip();
+
+
+/*
+ * Pipelined ingestion
+ */
+/**
+ * @brief unit test for extractProcessesPipeline
+ * Test the list extracted by the three stages against extractProcessesMapped
+ * (lines split between blocks, text timestamps, invalid lines, last line without end of line)
+ */
+void test_extractProcessesPipeline();
+
+
 #endif // TESTS_H
@@ -9,6 +9,12 @@
 #define TYPEDEF_H
 
 #include <iostream>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 using namespace std;
 
@@ -17,29 +23,85 @@ using namespace std;
  * mais vous ne pouvez pas modifier ou supprimer les champs existants
  */
 
+/*
+ * Value of Activity::timestamp when the time is unknown or could not be parsed
+ */
+const int64_t NO_TIMESTAMP = INT64_MIN;
+
+/*
+ * Value of TrieNode::firstCaseId when the case that ended on the node has grown since (tracked trie)
+ */
+const int UNKNOWN_CASE_ID = INT32_MIN;
+
+/*
+ * Order of the segments of a log directory (see logSegments)
+ * SEGMENTS_BY_TIME: oldest modification time first, natural order of the names between equal times
+ * SEGMENTS_BY_NAME: natural order of the names (split logs: log.1, log.2, log.10)
+ * SEGMENTS_ROTATED: reverse natural order of the names (logrotate: app.log.2, app.log.1, app.log)
+ */
+enum SegmentOrder
+{
+    SEGMENTS_BY_TIME,
+    SEGMENTS_BY_NAME,
+    SEGMENTS_ROTATED
+};
+
 /*
  * Element of an activity list
- * name: the name of the activity (check-stock-availability)
- * time: the time at which the activity occurred (Tue-Oct--3-11:38:33-2023)
+ * name: the name of the activity (check-stock-availability), only set on activities built by hand,
+ *       the activities added by addActivity carry the code only (see getActivityName)
+ * time: the time at which the activity occurred (Tue-Oct--3-11:38:33-2023), only kept when
+ *       it could not be parsed into timestamp (or on activities built by hand)
+ * code: the code of the name in the activity dictionary, -1 if not interned yet
+ * timestamp: the time in seconds since 1970-01-01 00:00:00 UTC, NO_TIMESTAMP if unknown
  */
 struct Activity
 {
     string name;
     string time;
     Activity * nextActivity = nullptr;
+    int code = -1;
+    int64_t timestamp = NO_TIMESTAMP;
 };
 
+/*
+ * Bump allocator owning the Process, Activity and SummaryCell of a process list
+ * blocks: every block allocated so far, current / used / capacity: the block being filled
+ * withText: the activities that own a non empty string, destroyed when the arena is released
+ */
+struct Arena
+{
+    vector<char *> blocks;
+    char * current = nullptr;
+    size_t used = 0;
+    size_t capacity = 0;
+    vector<Activity *> withText;
+};
+
+
 /*
  * Element of a process list
  * nbActivities: the number of activities in the process
  * id: the Id of the process (34594400)
+ * lastActivity: the last activity added by push_back, nullptr if unknown (list built by hand)
+ * arena: the arena the process and its activities are allocated in, nullptr if allocated with new
+ * frequency: for a variant, the number of cases following it (0 for a case)
+ * trie / trieNode: the variant trie of the list when it tracks variants (see trackVariants),
+ * and the node of the activity sequence of the process in this trie
  */
+struct VariantTrie;
+
 struct Process
 {
     int nbActivities = 0;
     int id = 0;
     Activity * firstActivity = nullptr;
     Process * nextProcess = nullptr;
+    Activity * lastActivity = nullptr;
+    Arena * arena = nullptr;
+    int frequency = 0;
+    VariantTrie * trie = nullptr;
+    int trieNode = 0;
 };
 
 
@@ -56,13 +118,377 @@ struct SummaryCell
 };
 
 
+/*
+ * Open-addressing hash index of the processes of a list (linear probing)
+ * ids / processes: the slots, a nullptr process marks an empty slot
+ * capacity: the number of slots (a power of 2, 0 before the first insertion)
+ * size: the number of indexed processes
+ * version: the ProcessList::version the index was built for, the index is up to date while
+ * version == ProcessList::version and size == ProcessList::size (-1: never built)
+ */
+struct ProcessIndex
+{
+    int * ids = nullptr;
+    Process ** processes = nullptr;
+    size_t capacity = 0;
+    int size = 0;
+    int64_t version = -1;
+};
+
+
 /*
  * Definition of a process list
+ * index: id -> process index, maintained by push_front and used by processExists
+ * version: incremented by every function that adds, removes or replaces processes of the list
+ * (code that edits the chain by hand must increment it too, the index is then rebuilt)
+ * arena: the arena the nodes of the list are allocated in (see enableArena), nullptr to use new/delete
+ * variantTrie: the variants of the list updated at each added activity (see trackVariants), nullptr if not tracked
  */
 struct ProcessList
 {
     int size = 0;
     Process * firstProcess = nullptr;
     SummaryCell * Summary = nullptr;
+    ProcessIndex index;
+    int64_t version = 0;
+    Arena * arena = nullptr;
+    VariantTrie * variantTrie = nullptr;
+};
+
+
+/*
+ * Columnar (CSR) copy of a process list
+ * ids: the id of each case, in the order of the process list
+ * offsets: the events of case i are at [offsets[i], offsets[i + 1]) (nbCases + 1 values)
+ * codes: the activity code of each event, case after case, in order
+ * timestamps: the timestamp of each event, same layout as codes
+ */
+struct EventStore
+{
+    vector<int> ids;
+    vector<size_t> offsets;
+    vector<int> codes;
+    vector<int64_t> timestamps;
+};
+
+
+/*
+ * Read-only view of a whole log file
+ * data: the first byte of the file (mapped in memory, or loaded in a buffer on Windows)
+ * size: the number of bytes of the file
+ * fd: the file descriptor kept open while the file is mapped
+ */
+struct MappedFile
+{
+    const char * data = nullptr;
+    size_t size = 0;
+    int fd = -1;
+};
+
+
+/*
+ * One line of a log, tokenized in place inside a buffer
+ * id: the Id of the process (34594400)
+ * name / nameLength: the activity name, not null terminated
+ * time / timeLength: the timestamp, not null terminated
+ */
+struct EventToken
+{
+    int id = 0;
+    const char * name = nullptr;
+    size_t nameLength = 0;
+    const char * time = nullptr;
+    size_t timeLength = 0;
+};
+
+
+/*
+ * Header of a snapshot file (see saveSnapshot), followed by 8 bytes aligned sections:
+ * the activity dictionary (nbNames + 1 offsets then namesSize chars), the case table
+ * (nbCases ids then nbCases + 1 offsets), the events (nbEvents codes then nbEvents timestamps)
+ * the unparseable times (nbTexts event indexes, nbTexts + 1 offsets then textsSize chars)
+ * and the tracked variant trie of the list (nbTrieNodes TrieNode, nbTrieVariants node indexes
+ * then the node of each of the nbCases cases), nbTrieNodes is 0 if the list didn't track its variants
+ * byteOrder: SNAPSHOT_BYTE_ORDER as written by the machine that saved the snapshot
+ * sourceSize / sourceTime: size and modification time of the log the list was extracted from, 0 if unknown
+ */
+const char SNAPSHOT_MAGIC[8] = {'O', 'P', 'T', 'I', 'S', 'N', 'A', 'P'};
+const uint32_t SNAPSHOT_VERSION = 2;
+const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version = SNAPSHOT_VERSION;
+    uint32_t byteOrder = SNAPSHOT_BYTE_ORDER;
+    uint64_t sourceSize = 0;
+    int64_t sourceTime = 0;
+    uint64_t nbNames = 0;
+    uint64_t namesSize = 0;
+    uint64_t nbCases = 0;
+    uint64_t nbEvents = 0;
+    uint64_t nbTexts = 0;
+    uint64_t textsSize = 0;
+    uint64_t nbTrieNodes = 0;
+    uint64_t nbTrieVariants = 0;
+};
+
+
+/*
+ * Node of a variant trie, the nodes are stored in a vector and linked by index
+ * code: the activity code of the node (-1 for the root)
+ * parent / firstChild / nextSibling: the index of the linked nodes, -1 if none
+ * nbCases: the number of cases starting with the sequence ending at this node
+ * frequency: the number of cases following exactly this sequence (0 if it isn't a variant)
+ * firstCaseId: the id of the first case following exactly this sequence,
+ * UNKNOWN_CASE_ID in a tracked trie when that case has grown and no other case has ended on the node since
+ * variantRank: the position of the node in VariantTrie::variants, -1 if it was never a variant
+ */
+struct TrieNode
+{
+    int code = -1;
+    int parent = -1;
+    int firstChild = -1;
+    int nextSibling = -1;
+    int nbCases = 0;
+    int frequency = 0;
+    int firstCaseId = 0;
+    int variantRank = -1;
+};
+
+
+/*
+ * Prefix trie of the activity sequences of a process list (see buildTrie)
+ * nodes: the nodes, the root is nodes[0]
+ * variants: the index of the terminal nodes, in order of first appearance
+ * (in a tracked trie a node stays listed when its cases grow further, with frequency 0)
+ */
+struct VariantTrie
+{
+    vector<TrieNode> nodes;
+    vector<int> variants;
+};
+
+
+/*
+ * One of the most frequent variants (see topVariants)
+ * variant: the variant, in the variant list filled by topVariants (its frequency is its number of cases)
+ * coverage: the percentage of the cases following the variant
+ * caseIds: the ids of the cases following the variant, ascending, encoded as varints:
+ * the first id (zigzag encoded) then the difference with the previous id
+ */
+struct TopVariant
+{
+    Process * variant = nullptr;
+    double coverage = 0;
+    vector<uint8_t> caseIds;
+};
+
+
+/*
+ * Directly-follows graph of a log (see buildDfg)
+ * nbActivities: the number of activity codes, the size of a row of edges
+ * edges: edges[from * nbActivities + to] the number of times activity "to" directly follows "from" in a case
+ * starts / ends: the number of cases starting / ending with each activity code
+ */
+struct DirectlyFollowsGraph
+{
+    int nbActivities = 0;
+    vector<int64_t> edges;
+    vector<int64_t> starts;
+    vector<int64_t> ends;
+};
+
+
+/*
+ * Mergeable quantile sketch (KLL): the values are kept in levels, a value of level h stands for 2^h values.
+ * When a level is full it is sorted and one value out of two is promoted to the next level,
+ * so the memory stays about 3k values whatever the number of values added
+ * k: the capacity of the highest level, the accuracy (rank error about 1.7 / k)
+ * count / sum / min / max: exact statistics of the values added
+ * levels: the values kept at each level
+ * coin: the state of the generator choosing which half of a level is promoted (deterministic)
+ */
+struct QuantileSketch
+{
+    int k = 200;
+    int64_t count = 0;
+    double sum = 0;
+    double min = 0;
+    double max = 0;
+    vector<vector<double>> levels;
+    uint32_t coin = 1;
+};
+
+
+/*
+ * Duration statistics of a log, in seconds (see durationStatistics)
+ * caseDurations: the throughput time of each case, from its first to its last timestamp
+ * waitingTimes: the time between two consecutive activities of a case, both with a timestamp
+ * transitionWaits: the waiting times of each transition, key from * nbActivities + to
+ */
+struct DurationStatistics
+{
+    int nbActivities = 0;
+    QuantileSketch caseDurations;
+    QuantileSketch waitingTimes;
+    unordered_map<size_t, QuantileSketch> transitionWaits;
+};
+
+
+/*
+ * State of a log file followed like tail -f (see followOpen)
+ * fileName: the followed file
+ * offset: the number of bytes of the file already read
+ * device / inode: the identity of the file read (st_dev, st_ino), the file is read again from the beginning when it changes
+ * pending: the bytes read after the last complete line, parsed once the line is complete
+ * starts / ends: the start and end histograms of the list, indexed by activity code, updated at each event
+ * nbEvents / nbInvalid: the number of events added and of invalid lines since followOpen
+ * notifier / watch: the inotify descriptors (Linux), -1 when the file is polled
+ */
+struct LogFollower
+{
+    string fileName;
+    size_t offset = 0;
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    string pending;
+    vector<int> starts;
+    vector<int> ends;
+    int64_t nbEvents = 0;
+    int nbInvalid = 0;
+    int notifier = -1;
+    int watch = -1;
+};
+
+
+/*
+ * A case open in a streaming analysis
+ * process: the activities of the case, allocated with new and freed when the case is finished
+ * lastSeen: the log clock (CaseStream::clock) at the last event of the case, NO_TIMESTAMP if unknown
+ * serial: the number of the case among the cases opened by the stream (an id can be reused by a later case)
+ * isScheduled: true when the case has its entry in CaseStream::expiries
+ */
+struct StreamCase
+{
+    Process * process = nullptr;
+    int64_t lastSeen = NO_TIMESTAMP;
+    int64_t serial = 0;
+    bool isScheduled = false;
+};
+
+
+/*
+ * Entry of the expiry heap of a streaming analysis: the case serial opened with the id
+ * was last seen at time (the case may have been seen later since, or be finished)
+ */
+struct CaseExpiry
+{
+    int64_t time = 0;
+    int id = 0;
+    int64_t serial = 0;
+};
+
+
+/*
+ * Streaming analysis keeping only the open cases in memory (see streamOpen)
+ * isEndActivity: for each activity code, true if the activity finishes a case
+ * timeout: a case without event for more than timeout seconds (log time) is finished, 0 for no timeout
+ * openCases: the open cases by id
+ * expiries: heap of the expiries, earliest first, at most one entry per case
+ * (an entry is moved to the last event of its case when it comes out, dropped if its case is finished)
+ * nbOpened: the number of cases opened since streamOpen (serial of the next case)
+ * clock: the latest timestamp of the log, NO_TIMESTAMP before the first dated event
+ * variants / dfg / caseLengths: the aggregates of the finished cases (variants, directly-follows graph, number of activities)
+ * nbEvents: the number of events received
+ * nbEnded / nbTimedOut / nbFinished: the cases finished by an end activity, by the timeout, in all
+ * maxOpenCases: the highest number of cases open at the same time
+ */
+struct CaseStream
+{
+    vector<bool> isEndActivity;
+    int64_t timeout = 0;
+    unordered_map<int, StreamCase> openCases;
+    vector<CaseExpiry> expiries;
+    int64_t nbOpened = 0;
+    int64_t clock = NO_TIMESTAMP;
+    VariantTrie variants;
+    DirectlyFollowsGraph dfg;
+    QuantileSketch caseLengths;
+    int64_t nbEvents = 0;
+    int nbEnded = 0;
+    int nbTimedOut = 0;
+    int nbFinished = 0;
+    int maxOpenCases = 0;
+};
+
+
+/*
+ * Bounded buffer of blocks between a producer thread and a consumer thread (see extractProcessesGzip)
+ * blocks / sizes: the slots, allocated once, and the number of bytes used in each slot
+ * first / nbFilled: the oldest filled slot and the number of filled slots (the slots are used in a circle)
+ * isClosed: true when the producer will not fill any other slot
+ * guard / changed: protect the counters, signal a filled or a released slot
+ */
+struct BlockQueue
+{
+    vector<vector<char>> blocks;
+    vector<size_t> sizes;
+    size_t first = 0;
+    size_t nbFilled = 0;
+    bool isClosed = false;
+    mutex guard;
+    condition_variable changed;
+};
+
+
+/*
+ * Lock-free bounded ring between one producer thread and one consumer thread (see extractProcessesPipeline)
+ * slots: the values in transit (buffer indexes), the size is a power of 2
+ * head: the number of values read by the consumer, tail: the number of values written by the producer
+ * (both only increase, on separate cache lines)
+ * isClosed: set by the producer after its last value
+ * nbSleeping, guard, changed: a thread that has spun too long on a full or empty ring sleeps on changed,
+ * the other side only takes guard to wake it when nbSleeping is not 0
+ */
+struct SpscRing
+{
+    vector<int> slots;
+    alignas(64) atomic<size_t> head{0};
+    alignas(64) atomic<size_t> tail{0};
+    atomic<bool> isClosed{false};
+    atomic<int> nbSleeping{0};
+    mutex guard;
+    condition_variable changed;
+};
+
+
+/*
+ * One event parsed by the parse stage of the pipeline
+ * id: the Id of the process
+ * code: the code of the activity (see internActivity)
+ * timestamp: the parsed time, NO_TIMESTAMP if it can't be parsed
+ * text: the index of the time text in EventBatch::texts when it can't be parsed, -1 otherwise
+ */
+struct ParsedEvent
+{
+    int id = 0;
+    int code = 0;
+    int64_t timestamp = NO_TIMESTAMP;
+    int text = -1;
+};
+
+
+/*
+ * Batch of parsed events handed from the parse stage to the insert stage
+ * events: the events, in file order
+ * texts: the time texts that can't be parsed
+ * nbInvalid: the number of invalid lines met while parsing the batch
+ */
+struct EventBatch
+{
+    vector<ParsedEvent> events;
+    vector<string> texts;
+    int nbInvalid = 0;
 };
 #endif // TYPEDEF_H